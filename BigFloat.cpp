@@ -0,0 +1,1441 @@
+/*
+ * BigFloat.cpp
+ *
+ * Implementation of the BigFloat class and its elementary functions. See
+ * comments in BigFloat.h for details.
+ *
+ */
+
+#include "BigFloat.h"
+#include "NumberTheory.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+
+/*
+ * Non-member utility functions (in anonymous namespace -- file scope only).
+ *
+ */
+
+namespace { /* anonymous namespace */
+
+using iota::HugeInt;
+using iota::RoundingMode;
+
+// powers 5^n with n up to this bound are formed exactly in conversions
+const unsigned long exactFivePowers{1000};
+
+// largest number of significant digits in decimal conversions
+const int maxDecimalDigits{iota::maxPrecision / 3};
+
+/*
+ * Throw std::invalid_argument unless 2 <= precision <= maxPrecision.
+ *
+ */
+
+void check_precision(int precision) {
+    if (precision < 2 || precision > iota::maxPrecision) {
+        throw std::invalid_argument{"BigFloat precision out of range."};
+    }
+}
+
+/*
+ * Return 2^n, n >= 0.
+ *
+ */
+
+HugeInt power_of_two(long n) {
+    HugeInt result{1LL};
+
+    return result.shiftLeftBits(static_cast<int>(n));
+}
+
+/*
+ * Return x * 2^bits, truncated toward zero if bits < 0, for x of either
+ * sign.
+ *
+ */
+
+HugeInt signed_shift(const HugeInt& x, long bits) {
+    const long maxShift{1L << 20};      // beyond the width of any HugeInt
+    const bool negative{x.isNegative()};
+    HugeInt    magnitude{negative ? -x : x};
+
+    if (bits >= 0) {
+        magnitude.shiftLeftBits(static_cast<int>(std::min(bits, maxShift)));
+    }
+    else {
+        magnitude.shiftRightBits(static_cast<int>(std::min(-bits, maxShift)));
+    }
+
+    return negative ? -magnitude : magnitude;
+}
+
+/*
+ * Return the number of trailing zero bits of x > 0.
+ *
+ */
+
+long trailing_zero_bits(HugeInt x) {
+    const std::uint32_t lowMask{1U << 31};
+    long                count{0};
+
+    for (std::uint32_t low = x.shortModulo(lowMask); low == 0;
+         low = x.shortModulo(lowMask)) {
+        x.shiftRightBits(31);
+        count += 31;
+    }
+
+    for (std::uint32_t low = x.shortModulo(lowMask); (low & 1) == 0;
+         low >>= 1) {
+        ++count;
+    }
+
+    return count;
+}
+
+/*
+ * Return m * 2^-drop rounded to an integer, for m of either sign and
+ * drop >= 0. If sticky is true, the magnitude of the value being rounded
+ * is slightly larger than |m| * 2^-drop (some nonzero bits were lost below
+ * m); callers must then leave at least two bits to be dropped, so that the
+ * rounding direction is determined.
+ *
+ */
+
+HugeInt round_shift(const HugeInt& m, long drop, RoundingMode mode,
+                    bool sticky) {
+    const bool negative{m.isNegative()};
+    HugeInt    magnitude{negative ? -m : m};
+    HugeInt    q;
+    int        halfComparison{-1};      // sign of (dropped part - half ulp)
+    bool       inexact{sticky};
+
+    if (drop == 0) {
+        q = magnitude;
+    }
+    else if (drop > magnitude.bitLength()) {
+        inexact = inexact || !magnitude.isZero();
+    }
+    else {
+        q = magnitude;
+        q.shiftRightBits(static_cast<int>(drop));
+
+        HugeInt low{q};
+        low = magnitude - low.shiftLeftBits(static_cast<int>(drop));
+
+        const HugeInt half{power_of_two(drop - 1)};
+        if (low > half || (low == half && sticky)) {
+            halfComparison = 1;
+        }
+        else if (low == half) {
+            halfComparison = 0;
+        }
+
+        inexact = inexact || !low.isZero();
+    }
+
+    bool roundUp{false};
+
+    switch (mode) {
+    case RoundingMode::nearestEven:
+        roundUp = halfComparison > 0
+                  || (halfComparison == 0 && q.shortModulo(2) == 1);
+        break;
+    case RoundingMode::towardZero:
+        break;
+    case RoundingMode::towardPositive:
+        roundUp = inexact && !negative;
+        break;
+    case RoundingMode::towardNegative:
+        roundUp = inexact && negative;
+        break;
+    }
+
+    if (roundUp) {
+        ++q;
+    }
+
+    return negative ? -q : q;
+}
+
+/*
+ * Return an approximation to 2^(bitLength(b) + k) / b, for b > 0, accurate
+ * to a few units in the last place: a k-bit reciprocal.
+ *
+ * Newton's iteration X' = X + X (1 - b X) roughly doubles the number of
+ * correct bits at each step, and only as many leading bits of b as are
+ * correct in the new X are used, so the work at each step is proportional
+ * to its precision.
+ *
+ */
+
+HugeInt reciprocal(const HugeInt& b, long k) {
+    const long length{b.bitLength()};
+
+    // b truncated (or extended) to n bits; 2^(n + j) / b_n has the same
+    // leading bits as 2^(length + j) / b.
+    auto leading = [&](long n) {
+        return signed_shift(b, n - length);
+    };
+
+    long    j{std::min(k, 30L)};
+    HugeInt X{power_of_two(62 + j) / leading(62)};
+
+    while (j < k) {
+        const long    next{std::min(2 * j - 4, k)};
+        const long    n{next + 4};
+        const HugeInt bn{leading(n)};
+
+        // error E = 2^(n + j) - X b_n, of about n - j bits
+        const HugeInt E{power_of_two(n + j) - X * bn};
+
+        X = signed_shift(X, next - j) + signed_shift(X * E, next - n - 2 * j);
+        j = next;
+    }
+
+    return X;
+}
+
+/*
+ * Return floor(a / b) for a >= 0 and b > 0, and the remainder in
+ * *remainder: the quotient is estimated from the leading bits of a and a
+ * Newton reciprocal of b, then corrected against the exact remainder.
+ *
+ */
+
+HugeInt newton_divide(const HugeInt& a, const HugeInt& b,
+                      HugeInt* const remainder) {
+    if (a < b) {
+        *remainder = a;
+        return 0LL;
+    }
+
+    const long la{a.bitLength()};
+    const long lb{b.bitLength()};
+    const long k{la - lb + 9};          // quotient bits, plus guard bits
+    const long t{std::max(0L, la - (k + 2))};
+
+    HugeInt aTop{a};
+    aTop.shiftRightBits(static_cast<int>(t));
+
+    HugeInt q{aTop * reciprocal(b, k)};
+    q.shiftRightBits(static_cast<int>(lb + k - t));
+
+    HugeInt r{a - q * b};
+
+    while (r.isNegative()) {
+        --q;
+        r += b;
+    }
+    while (r >= b) {
+        ++q;
+        r -= b;
+    }
+
+    *remainder = r;
+
+    return q;
+}
+
+/*
+ * A power of five, mantissa * 2^exponent, exact if `exact' is set and
+ * otherwise truncated to a given number of bits.
+ *
+ */
+
+struct FivePower {
+    HugeInt mantissa;
+    long    exponent;
+    bool    exact;
+};
+
+/*
+ * Return 5^n, exactly for n <= exactFivePowers and otherwise to `bits'
+ * bits, by left-to-right binary exponentiation.
+ *
+ */
+
+FivePower power_of_five(unsigned long n, long bits) {
+    FivePower result{1LL, 0, true};
+
+    unsigned long mask{1};
+    while (mask <= n / 2) {
+        mask <<= 1;
+    }
+
+    for ( ; n != 0 && mask != 0; mask >>= 1) {
+        result.mantissa = result.mantissa * result.mantissa;
+        result.exponent *= 2;
+        if ((n & mask) != 0) {
+            result.mantissa = result.mantissa * 5LL;
+        }
+
+        const long excess{result.mantissa.bitLength() - bits};
+        if (n > exactFivePowers && excess > 0) {
+            result.mantissa.shiftRightBits(static_cast<int>(excess));
+            result.exponent += excess;
+            result.exact = false;
+        }
+    }
+
+    return result;
+}
+
+/*
+ * Fixed point arithmetic: an integer X represents the real number X / 2^w
+ * for a working precision of w bits.
+ *
+ */
+
+HugeInt fixed_multiply(const HugeInt& a, const HugeInt& b, long w) {
+    return signed_shift(a * b, -w);
+}
+
+/*
+ * Return the fixed point value of x with w fractional bits.
+ *
+ */
+
+HugeInt to_fixed(const iota::BigFloat& x, long w) {
+    return signed_shift(x.getMantissa(), x.getExponent() + w);
+}
+
+/*
+ * Return log 2 to w fractional bits, from log 2 = 2 atanh(1/3), i.e.,
+ *
+ *     log 2 = sum 2 / ((2i + 1) 3^(2i + 1)),   i = 0, 1, 2, ...
+ *
+ * summed with 16 guard bits.
+ *
+ */
+
+HugeInt fixed_log2(long w) {
+    const long guard{16};
+    HugeInt    term{power_of_two(w + guard + 1) / 3LL};
+    HugeInt    sum;
+
+    for (long long i = 0; !term.isZero(); ++i) {
+        sum += term / (2 * i + 1);
+        term /= 9LL;
+    }
+
+    return signed_shift(sum, -guard);
+}
+
+/*
+ * Return atan(1/n) to w fractional bits (with the caller's guard bits):
+ *
+ *     atan(1/n) = sum (-1)^i / ((2i + 1) n^(2i + 1)),   i = 0, 1, 2, ...
+ *
+ */
+
+HugeInt fixed_arccot(long long n, long w) {
+    HugeInt term{power_of_two(w) / n};
+    HugeInt sum;
+
+    for (long long i = 0; !term.isZero(); ++i) {
+        if (i % 2 == 0) {
+            sum += term / (2 * i + 1);
+        }
+        else {
+            sum -= term / (2 * i + 1);
+        }
+        term /= n * n;
+    }
+
+    return sum;
+}
+
+/*
+ * Return pi to w fractional bits, from Machin's formula
+ * pi = 16 atan(1/5) - 4 atan(1/239), summed with 16 guard bits.
+ *
+ */
+
+HugeInt fixed_pi(long w) {
+    const long guard{16};
+    const HugeInt pi{16LL * fixed_arccot(5, w + guard)
+                     - 4LL * fixed_arccot(239, w + guard)};
+
+    return signed_shift(pi, -guard);
+}
+
+/*
+ * Return the number of argument halvings used by the elementary functions
+ * at a given precision: about sqrt(precision) / 2, which balances the
+ * number of series terms against the number of doublings.
+ *
+ */
+
+long halvings(int precision) {
+    long j{0};
+    while (4 * j * j < precision) {
+        ++j;
+    }
+
+    return j;
+}
+
+/*
+ * Return floor(log10(|x|)) estimated from the binary exponent of x, which
+ * may be low by one.
+ *
+ */
+
+long decimal_exponent(const iota::BigFloat& x) {
+    const HugeInt& m{x.getMantissa()};
+    const long     top{x.getExponent()
+                       + (m.isNegative() ? -m : m).bitLength()};
+
+    return static_cast<long>(std::floor((top - 1) * 0.30102999566398120));
+}
+
+/*
+ * Throw std::range_error if |x| >= 2^40 (for exp, sin and cos).
+ *
+ */
+
+void check_reducible(const iota::BigFloat& x, const char* const name) {
+    const HugeInt& m{x.getMantissa()};
+
+    if (x.getExponent() + (m.isNegative() ? -m : m).bitLength() > 40) {
+        throw std::range_error{std::string{name}
+                               + ": argument out of range."};
+    }
+}
+
+/*
+ * sin x (cosine = false) or cos x (cosine = true). x is reduced by the
+ * nearest multiple k of pi/2 to |r| <= pi/4, and r halved j times before the
+ * Taylor series for sin and cos are summed; the double angle formulae
+ * then restore r, and k mod 4 selects the result.
+ *
+ */
+
+iota::BigFloat sin_cos(const iota::BigFloat& x, bool cosine) {
+    const int precision{x.getPrecision()};
+
+    if (x.isZero()) {
+        return iota::BigFloat{cosine ? 1LL : 0LL, precision};
+    }
+
+    check_reducible(x, cosine ? "cos" : "sin");
+
+    const HugeInt& m{x.getMantissa()};
+    const long     top{x.getExponent() + (m.isNegative() ? -m : m).bitLength()};
+
+    // Small |x|: sin x = x (1 - x^2/3! + x^4/5! - ...), keeping full
+    // relative precision.
+    if (!cosine && top <= -16) {
+        const long    w{precision + 64L};
+        const HugeInt X{to_fixed(x, w)};
+        const HugeInt X2{fixed_multiply(X, X, w)};
+        HugeInt       term{power_of_two(w)};
+        HugeInt       factor;
+
+        for (long long i = 1; !term.isZero(); i += 2) {
+            factor += term;
+            term = -fixed_multiply(term, X2, w) / ((i + 1) * (i + 2));
+        }
+
+        return iota::BigFloat::fromMantissa(m * factor, x.getExponent() - w,
+                                            precision);
+    }
+
+    const long j{halvings(precision)};
+    const long w{precision + j + 64};
+    const long reduction{w + 48};
+
+    const HugeInt halfPi{signed_shift(fixed_pi(reduction), -1)};
+    const HugeInt quarterPi{signed_shift(halfPi, -1)};
+    const HugeInt X{to_fixed(x, reduction)};
+
+    HugeInt k{X / halfPi};
+    HugeInt r{X - k * halfPi};
+
+    if (r > quarterPi) {
+        r -= halfPi;
+        ++k;
+    }
+    else if (r < -quarterPi) {
+        r += halfPi;
+        --k;
+    }
+
+    const HugeInt one{power_of_two(w)};
+    const HugeInt R{signed_shift(r, w - reduction - j)};
+    const HugeInt R2{fixed_multiply(R, R, w)};
+
+    HugeInt s;
+    HugeInt c;
+
+    HugeInt term{R};
+    for (long long i = 1; !term.isZero(); i += 2) {
+        s += term;
+        term = -fixed_multiply(term, R2, w) / ((i + 1) * (i + 2));
+    }
+
+    term = one;
+    for (long long i = 0; !term.isZero(); i += 2) {
+        c += term;
+        term = -fixed_multiply(term, R2, w) / ((i + 1) * (i + 2));
+    }
+
+    // sin 2a = 2 sin a cos a, cos 2a = 1 - 2 sin^2 a
+    for (long i = 0; i < j; ++i) {
+        const HugeInt doubled{2LL * fixed_multiply(s, c, w)};
+        c = one - 2LL * fixed_multiply(s, s, w);
+        s = doubled;
+    }
+
+    HugeInt quadrant{k % 4LL};
+    if (quadrant.isNegative()) {
+        quadrant += 4LL;
+    }
+
+    const HugeInt* value;
+    bool           negate;
+
+    if (quadrant == 0LL) {
+        value = cosine ? &c : &s;
+        negate = false;
+    }
+    else if (quadrant == 1LL) {
+        value = cosine ? &s : &c;
+        negate = cosine;
+    }
+    else if (quadrant == 2LL) {
+        value = cosine ? &c : &s;
+        negate = true;
+    }
+    else {
+        value = cosine ? &s : &c;
+        negate = !cosine;
+    }
+
+    return iota::BigFloat::fromMantissa(negate ? -*value : *value, -w,
+                                        precision);
+}
+
+} /* anonymous namespace */
+
+
+
+namespace iota {
+
+/**
+ * Constructor: conversion from long long int, rounded to the given
+ * precision.
+ *
+ * @param value
+ * @param precision
+ */
+
+BigFloat::BigFloat(long long int value, int precision) {
+    check_precision(precision);
+    *this = round(value, 0, precision, RoundingMode::nearestEven);
+}
+
+/**
+ * Constructor: conversion from HugeInt, rounded to the given precision.
+ *
+ * @param value
+ * @param precision
+ * @param mode
+ */
+
+BigFloat::BigFloat(const HugeInt& value, int precision, RoundingMode mode) {
+    check_precision(precision);
+    *this = round(value, 0, precision, mode);
+}
+
+/**
+ * Constructor: conversion from a decimal string such as "-12.345e-67"
+ * (optional sign, digits with an optional decimal point, optional
+ * exponent), rounded to the given precision. Throws std::invalid_argument
+ * if the string is not of this form or has more than maxPrecision / 3
+ * significant digits.
+ *
+ * The digits form an integer D and the value is D * 10^E = D * 5^E * 2^E,
+ * so a single rounded multiplication or division by 5^|E| is needed.
+ *
+ * @param str
+ * @param precision
+ * @param mode
+ */
+
+BigFloat::BigFloat(const char* const str, int precision, RoundingMode mode) {
+    check_precision(precision);
+
+    const char* s{str};
+    bool        negative{false};
+
+    if (*s == '+' || *s == '-') {
+        negative = *s == '-';
+        ++s;
+    }
+
+    std::string digits;
+    long        exponent{0};
+    bool        point{false};
+
+    for ( ; std::isdigit(static_cast<unsigned char>(*s)) || *s == '.'; ++s) {
+        if (*s == '.') {
+            if (point) {
+                break;
+            }
+            point = true;
+        }
+        else {
+            digits += *s;
+            if (point) {
+                --exponent;
+            }
+        }
+    }
+
+    if (digits.empty()) {
+        throw std::invalid_argument{"BigFloat string contains no digits."};
+    }
+
+    if (*s == 'e' || *s == 'E') {
+        char* end;
+        const long long e{std::strtoll(s + 1, &end, 10)};
+
+        if (end == s + 1 || e > 1000000000000LL || e < -1000000000000LL) {
+            throw std::invalid_argument{"BigFloat string has bad exponent."};
+        }
+        exponent += static_cast<long>(e);
+        s = end;
+    }
+
+    if (*s != '\0') {
+        throw std::invalid_argument{"BigFloat string contains non-digit."};
+    }
+
+    digits.erase(0, std::min(digits.find_first_not_of('0'),
+                             digits.size() - 1));
+    if (static_cast<int>(digits.size()) > maxDecimalDigits) {
+        throw std::invalid_argument{"BigFloat string has too many digits."};
+    }
+
+    HugeInt D{digits.c_str()};
+    if (negative) {
+        D = -D;
+    }
+
+    if (D.isZero()) {
+        *this = round(D, 0, precision, mode);
+        return;
+    }
+
+    const unsigned long n{static_cast<unsigned long>(std::labs(exponent))};
+    const FivePower     five{power_of_five(n, precision + 64L)};
+
+    if (exponent >= 0) {
+        *this = round(D * five.mantissa, exponent + five.exponent, precision,
+                      mode, !five.exact);
+    }
+    else {
+        *this = quotient(D, exponent, five.mantissa, five.exponent, precision,
+                         mode);
+    }
+}
+
+/**
+ * fromMantissa()
+ *
+ * Return mantissa * 2^exponent rounded to the given precision. Static
+ * member function.
+ *
+ * @param mantissa
+ * @param exponent
+ * @param precision
+ * @param mode
+ * @return
+ */
+
+BigFloat BigFloat::fromMantissa(const HugeInt& mantissa, long exponent,
+                                int precision, RoundingMode mode) {
+    check_precision(precision);
+
+    return round(mantissa, exponent, precision, mode);
+}
+
+/**
+ * Unary minus operator
+ *
+ * @return
+ */
+
+BigFloat BigFloat::operator-() const {
+    BigFloat result{*this};
+
+    result.mantissa_ = -mantissa_;
+
+    return result;
+}
+
+/**
+ * toHugeInt()
+ *
+ * Return the BigFloat rounded to an integer in the given rounding mode.
+ *
+ * WARNING: the integer is silently truncated if it is not representable as
+ * a HugeInt.
+ *
+ * @param mode
+ * @return
+ */
+
+HugeInt BigFloat::toHugeInt(RoundingMode mode) const {
+    if (exponent_ >= 0) {
+        return signed_shift(mantissa_, exponent_);
+    }
+
+    return round_shift(mantissa_, -exponent_, mode, false);
+}
+
+/**
+ * operator long double()
+ *
+ * Use with static_cast<long double>(x) to convert x to its approximate
+ * (long double) floating point value.
+ *
+ */
+
+BigFloat::operator long double() const {
+    const HugeInt magnitude{mantissa_.isNegative() ? -mantissa_ : mantissa_};
+    const long    excess{std::max(0L, magnitude.bitLength() - 64L)};
+
+    const long double value{static_cast<long double>(
+                                signed_shift(magnitude, -excess))};
+    const long double scaled{std::ldexp(value,
+                                 static_cast<int>(exponent_ + excess))};
+
+    return mantissa_.isNegative() ? -scaled : scaled;
+}
+
+/**
+ * add:
+ *
+ * Return a + b correctly rounded to the given precision.
+ *
+ * If b lies entirely below both the last bit of a and the rounding
+ * position, b only decides the direction of rounding: it is replaced by a
+ * single unit below the rounding position (of its sign), which rounds in
+ * the same way, so the aligned sum never grows with the gap between the
+ * exponents.
+ *
+ * @param a
+ * @param b
+ * @param precision
+ * @param mode
+ * @return
+ */
+
+BigFloat add(const BigFloat& a, const BigFloat& b, int precision,
+             RoundingMode mode) {
+    check_precision(precision);
+
+    if (a.isZero() || b.isZero()) {
+        const BigFloat& x{a.isZero() ? b : a};
+        return BigFloat::round(x.mantissa_, x.exponent_, precision, mode);
+    }
+
+    const HugeInt magnitudeA{a.isNegative() ? -a.mantissa_ : a.mantissa_};
+    const HugeInt magnitudeB{b.isNegative() ? -b.mantissa_ : b.mantissa_};
+    const long    topA{a.exponent_ + magnitudeA.bitLength()};
+    const long    topB{b.exponent_ + magnitudeB.bitLength()};
+
+    const bool      aLarger{topA >= topB};
+    const BigFloat& x{aLarger ? a : b};
+    const BigFloat& y{aLarger ? b : a};
+    const long      lengthX{(aLarger ? magnitudeA : magnitudeB).bitLength()};
+    const long      topX{aLarger ? topA : topB};
+    const long      topY{aLarger ? topB : topA};
+
+    const long shift{std::max(2L, precision + 3 - lengthX)};
+
+    if (topY <= std::min(x.exponent_ - 2, topX - precision - 3)) {
+        const HugeInt sum{signed_shift(x.mantissa_, shift)
+                          + (y.isNegative() ? -1LL : 1LL)};
+        return BigFloat::round(sum, x.exponent_ - shift, precision, mode);
+    }
+
+    const long    exponent{std::min(a.exponent_, b.exponent_)};
+    const HugeInt sum{signed_shift(a.mantissa_, a.exponent_ - exponent)
+                      + signed_shift(b.mantissa_, b.exponent_ - exponent)};
+
+    return BigFloat::round(sum, exponent, precision, mode);
+}
+
+/**
+ * subtract:
+ *
+ * Return a - b correctly rounded to the given precision.
+ *
+ * @param a
+ * @param b
+ * @param precision
+ * @param mode
+ * @return
+ */
+
+BigFloat subtract(const BigFloat& a, const BigFloat& b, int precision,
+                  RoundingMode mode) {
+    return add(a, -b, precision, mode);
+}
+
+/**
+ * multiply:
+ *
+ * Return a * b correctly rounded to the given precision.
+ *
+ * @param a
+ * @param b
+ * @param precision
+ * @param mode
+ * @return
+ */
+
+BigFloat multiply(const BigFloat& a, const BigFloat& b, int precision,
+                  RoundingMode mode) {
+    check_precision(precision);
+
+    return BigFloat::round(a.mantissa_ * b.mantissa_,
+                           a.exponent_ + b.exponent_, precision, mode);
+}
+
+/**
+ * divide:
+ *
+ * Return a / b correctly rounded to the given precision. Throws
+ * std::domain_error if b is zero.
+ *
+ * @param a
+ * @param b
+ * @param precision
+ * @param mode
+ * @return
+ */
+
+BigFloat divide(const BigFloat& a, const BigFloat& b, int precision,
+                RoundingMode mode) {
+    check_precision(precision);
+
+    if (b.isZero()) {
+        throw std::domain_error{"BigFloat division by zero."};
+    }
+
+    return BigFloat::quotient(a.mantissa_, a.exponent_, b.mantissa_,
+                              b.exponent_, precision, mode);
+}
+
+/**
+ * sqrt:
+ *
+ * Return the square root of x correctly rounded to the given precision,
+ * from the integer square root (with remainder) of the mantissa scaled to
+ * at least 2 * (precision + 2) bits and an even exponent. Throws
+ * std::domain_error if x is negative.
+ *
+ * @param x
+ * @param precision
+ * @param mode
+ * @return
+ */
+
+BigFloat sqrt(const BigFloat& x, int precision, RoundingMode mode) {
+    check_precision(precision);
+
+    if (x.isNegative()) {
+        throw std::domain_error{"sqrt of a negative BigFloat."};
+    }
+
+    if (x.isZero()) {
+        return BigFloat::round(x.mantissa_, 0, precision, mode);
+    }
+
+    long shift{std::max(0L, 2L * (precision + 2) - x.mantissa_.bitLength())};
+    if ((x.exponent_ - shift) % 2 != 0) {
+        ++shift;
+    }
+
+    HugeInt remainder;
+    const HugeInt root{isqrt(signed_shift(x.mantissa_, shift), &remainder)};
+
+    return BigFloat::round(root, (x.exponent_ - shift) / 2, precision, mode,
+                           !remainder.isZero());
+}
+
+/**
+ * Basic arithmetic operators: round to nearest (ties to even) at the larger
+ * of the operands' precisions.
+ *
+ * @param a
+ * @param b
+ * @return
+ */
+
+BigFloat operator+(const BigFloat& a, const BigFloat& b) {
+    return add(a, b, std::max(a.precision_, b.precision_),
+               RoundingMode::nearestEven);
+}
+
+BigFloat operator-(const BigFloat& a, const BigFloat& b) {
+    return subtract(a, b, std::max(a.precision_, b.precision_),
+                    RoundingMode::nearestEven);
+}
+
+BigFloat operator*(const BigFloat& a, const BigFloat& b) {
+    return multiply(a, b, std::max(a.precision_, b.precision_),
+                    RoundingMode::nearestEven);
+}
+
+BigFloat operator/(const BigFloat& a, const BigFloat& b) {
+    return divide(a, b, std::max(a.precision_, b.precision_),
+                  RoundingMode::nearestEven);
+}
+
+BigFloat& BigFloat::operator+=(const BigFloat& b) {
+    *this = *this + b;
+
+    return *this;
+}
+
+BigFloat& BigFloat::operator-=(const BigFloat& b) {
+    *this = *this - b;
+
+    return *this;
+}
+
+BigFloat& BigFloat::operator*=(const BigFloat& b) {
+    *this = *this * b;
+
+    return *this;
+}
+
+BigFloat& BigFloat::operator/=(const BigFloat& b) {
+    *this = *this / b;
+
+    return *this;
+}
+
+/**
+ * Relational operators: exact comparison of the values, regardless of
+ * precision.
+ *
+ * @param a
+ * @param b
+ * @return
+ */
+
+bool operator==(const BigFloat& a, const BigFloat& b) {
+    return a.exponent_ == b.exponent_ && a.mantissa_ == b.mantissa_;
+}
+
+bool operator!=(const BigFloat& a, const BigFloat& b) {
+    return !(a == b);
+}
+
+bool operator<(const BigFloat& a, const BigFloat& b) {
+    return BigFloat::compare(a, b) < 0;
+}
+
+bool operator>(const BigFloat& a, const BigFloat& b) {
+    return BigFloat::compare(a, b) > 0;
+}
+
+bool operator<=(const BigFloat& a, const BigFloat& b) {
+    return BigFloat::compare(a, b) <= 0;
+}
+
+bool operator>=(const BigFloat& a, const BigFloat& b) {
+    return BigFloat::compare(a, b) >= 0;
+}
+
+/**
+ * toString()
+ *
+ * Format the BigFloat in scientific notation with the given number of
+ * significant digits (1 to maxPrecision / 3), e.g., "-1.2345e-67", rounded
+ * to nearest. Throws std::invalid_argument if digits is out of range.
+ *
+ * With E = floor(log10|x|), the digits are the integer N = |x| 10^k,
+ * k = digits - 1 - E, rounded; |x| 10^k = |m| 5^k 2^(e + k) needs a single
+ * multiplication or division by 5^|k|. If the estimate of E is off by one,
+ * N has one digit too many or too few, and the step is repeated.
+ *
+ * @param digits
+ * @return
+ */
+
+std::string BigFloat::toString(int digits) const {
+    if (digits < 1 || digits > maxDecimalDigits) {
+        throw std::invalid_argument{"BigFloat::toString digits out of range."};
+    }
+
+    if (isZero()) {
+        return "0";
+    }
+
+    const HugeInt magnitude{isNegative() ? -mantissa_ : mantissa_};
+    const long    bits{static_cast<long>(digits * 3.3219280948873623) + 8};
+    const HugeInt lower{HugeInt{("1" + std::string(digits - 1, '0')).c_str()}};
+    const HugeInt upper{lower * 10LL};
+
+    long    decimalExponent{decimal_exponent(*this)};
+    HugeInt N;
+
+    for (;;) {
+        const long          k{digits - 1 - decimalExponent};
+        const unsigned long n{static_cast<unsigned long>(std::labs(k))};
+        const FivePower     five{power_of_five(n, bits + 64)};
+
+        HugeInt scaled;
+        long    exponent;
+        bool    sticky{false};
+
+        if (k >= 0) {
+            scaled = magnitude * five.mantissa;
+            exponent = exponent_ + k + five.exponent;
+        }
+        else {
+            const long shift{std::max(0L, bits + five.mantissa.bitLength()
+                                          - magnitude.bitLength())};
+            HugeInt    remainder;
+
+            scaled = newton_divide(signed_shift(magnitude, shift),
+                                   five.mantissa, &remainder);
+            exponent = exponent_ + k - shift - five.exponent;
+            sticky = !remainder.isZero();
+        }
+
+        N = exponent >= 0 ? signed_shift(scaled, exponent)
+                          : round_shift(scaled, -exponent,
+                                        RoundingMode::nearestEven, sticky);
+
+        if (N >= upper) {
+            ++decimalExponent;
+        }
+        else if (N < lower) {
+            --decimalExponent;
+        }
+        else {
+            break;
+        }
+    }
+
+    const std::string significand{N.toDigitString()};
+    std::string       result{isNegative() ? "-" : ""};
+
+    result += significand[0];
+    if (digits > 1) {
+        result += "." + significand.substr(1);
+    }
+    result += decimalExponent < 0 ? "e-" : "e+";
+    result += std::to_string(std::labs(decimalExponent));
+
+    return result;
+}
+
+/**
+ * operator<<
+ *
+ * Overloaded stream insertion for BigFloat, in scientific notation with as
+ * many significant digits as the precision warrants.
+ *
+ * @param output
+ * @param x
+ * @return
+ */
+
+std::ostream& operator<<(std::ostream& output, const BigFloat& x) {
+    return output << x.toString(
+               static_cast<int>(x.precision_ * 0.30102999566398120) + 1);
+}
+
+/**
+ * getMantissa()
+ *
+ * @return
+ */
+
+const HugeInt& BigFloat::getMantissa() const {
+    return mantissa_;
+}
+
+/**
+ * getExponent()
+ *
+ * @return
+ */
+
+long BigFloat::getExponent() const {
+    return exponent_;
+}
+
+/**
+ * getPrecision()
+ *
+ * @return
+ */
+
+int BigFloat::getPrecision() const {
+    return precision_;
+}
+
+/**
+ * isZero()
+ *
+ * @return
+ */
+
+bool BigFloat::isZero() const {
+    return mantissa_.isZero();
+}
+
+/**
+ * isNegative()
+ *
+ * @return
+ */
+
+bool BigFloat::isNegative() const {
+    return mantissa_.isNegative();
+}
+
+/**
+ * setPrecision()
+ *
+ * Round the BigFloat in place to a new precision (changes object).
+ *
+ * @param precision
+ * @param mode
+ * @return
+ */
+
+BigFloat& BigFloat::setPrecision(int precision, RoundingMode mode) {
+    check_precision(precision);
+    *this = round(mantissa_, exponent_, precision, mode);
+
+    return *this;
+}
+
+/**
+ * round: (private utility function)
+ *
+ * Return mantissa * 2^exponent rounded to precision bits. If sticky is
+ * true, the exact value has further nonzero bits below the mantissa (of
+ * the same sign); the mantissa is first extended, if necessary, so that at
+ * least two bits lie below the rounding position.
+ *
+ * @param mantissa
+ * @param exponent
+ * @param precision
+ * @param mode
+ * @param sticky
+ * @return
+ */
+
+BigFloat BigFloat::round(const HugeInt& mantissa, long exponent,
+                         int precision, RoundingMode mode, bool sticky) {
+    BigFloat result;
+    result.precision_ = precision;
+
+    if (mantissa.isZero()) {
+        return result;
+    }
+
+    HugeInt m{mantissa};
+    long    length{(m.isNegative() ? -m : m).bitLength()};
+
+    if (sticky && length < precision + 2) {
+        const long extend{precision + 2 - length};
+        m = signed_shift(m, extend);
+        exponent -= extend;
+        length += extend;
+    }
+
+    long drop{std::max(0L, length - precision)};
+    m = round_shift(m, drop, mode, sticky);
+
+    // rounding up to the next power of two
+    if ((m.isNegative() ? -m : m).bitLength() > precision) {
+        m = signed_shift(m, -1);
+        ++drop;
+    }
+
+    const long zeros{trailing_zero_bits(m.isNegative() ? -m : m)};
+
+    result.mantissa_ = signed_shift(m, -zeros);
+    result.exponent_ = exponent + drop + zeros;
+
+    return result;
+}
+
+/**
+ * quotient: (private utility function)
+ *
+ * Return (a * 2^ea) / (b * 2^eb), b nonzero, correctly rounded to precision
+ * bits. The dividend is scaled to exactly bitLength(b) + precision + 2 bits
+ * (any bits shifted out only set the sticky bit), so the quotient has at
+ * least precision + 2 bits, and is computed with newton_divide.
+ *
+ * @param a
+ * @param ea
+ * @param b
+ * @param eb
+ * @param precision
+ * @param mode
+ * @return
+ */
+
+BigFloat BigFloat::quotient(const HugeInt& a, long ea, const HugeInt& b,
+                            long eb, int precision, RoundingMode mode) {
+    if (a.isZero()) {
+        return round(a, 0, precision, mode);
+    }
+
+    const bool    negative{a.isNegative() != b.isNegative()};
+    const HugeInt magnitudeA{a.isNegative() ? -a : a};
+    const HugeInt magnitudeB{b.isNegative() ? -b : b};
+
+    const long shift{magnitudeB.bitLength() + precision + 2
+                     - magnitudeA.bitLength()};
+    const HugeInt dividend{signed_shift(magnitudeA, shift)};
+    bool          sticky{false};
+
+    if (shift < 0) {
+        sticky = signed_shift(dividend, -shift) != magnitudeA;
+    }
+
+    HugeInt remainder;
+    HugeInt q{newton_divide(dividend, magnitudeB, &remainder)};
+
+    sticky = sticky || !remainder.isZero();
+
+    return round(negative ? -q : q, ea - eb - shift, precision, mode, sticky);
+}
+
+/**
+ * compare: (private utility function)
+ *
+ * Return -1, 0 or 1 as a < b, a == b or a > b. Values of the same sign
+ * are ordered by their leading bit positions first, so that mantissas
+ * need only be aligned when those are equal.
+ *
+ * @param a
+ * @param b
+ * @return
+ */
+
+int BigFloat::compare(const BigFloat& a, const BigFloat& b) {
+    const int signA{a.isNegative() ? -1 : (a.isZero() ? 0 : 1)};
+    const int signB{b.isNegative() ? -1 : (b.isZero() ? 0 : 1)};
+
+    if (signA != signB || signA == 0) {
+        return signA < signB ? -1 : (signA > signB ? 1 : 0);
+    }
+
+    const HugeInt magnitudeA{signA < 0 ? -a.mantissa_ : a.mantissa_};
+    const HugeInt magnitudeB{signB < 0 ? -b.mantissa_ : b.mantissa_};
+    const long    topA{a.exponent_ + magnitudeA.bitLength()};
+    const long    topB{b.exponent_ + magnitudeB.bitLength()};
+    int           order;
+
+    if (topA != topB) {
+        order = topA < topB ? -1 : 1;
+    }
+    else {
+        const long    exponent{std::min(a.exponent_, b.exponent_)};
+        const HugeInt alignedA{signed_shift(magnitudeA, a.exponent_ - exponent)};
+        const HugeInt alignedB{signed_shift(magnitudeB, b.exponent_ - exponent)};
+
+        order = alignedA < alignedB ? -1 : (alignedA > alignedB ? 1 : 0);
+    }
+
+    return signA * order;
+}
+
+/**
+ * sqrt:
+ *
+ * Return the square root of x, correctly rounded to nearest at the
+ * precision of x.
+ *
+ * @param x
+ * @return
+ */
+
+BigFloat sqrt(const BigFloat& x) {
+    return sqrt(x, x.getPrecision(), RoundingMode::nearestEven);
+}
+
+/**
+ * exp:
+ *
+ * Return e^x at the precision of x. Throws std::range_error if
+ * |x| >= 2^40.
+ *
+ * x = k log 2 + r with |r| < log 2, and e^r = (e^(r/2^j))^(2^j), where the
+ * Taylor series for e^(r/2^j) converges quickly; e^x = 2^k e^r.
+ *
+ * @param x
+ * @return
+ */
+
+BigFloat exp(const BigFloat& x) {
+    const int precision{x.getPrecision()};
+
+    if (x.isZero()) {
+        return BigFloat{1LL, precision};
+    }
+
+    check_reducible(x, "exp");
+
+    const long j{halvings(precision)};
+    const long w{precision + j + 64};
+    const long reduction{w + 48};
+
+    const HugeInt log2{fixed_log2(reduction)};
+    const HugeInt X{to_fixed(x, reduction)};
+    const HugeInt k{X / log2};
+    const HugeInt R{signed_shift(X - k * log2, w - reduction - j)};
+
+    HugeInt sum;
+    HugeInt term{power_of_two(w)};
+
+    for (long long n = 1; !term.isZero(); ++n) {
+        sum += term;
+        term = fixed_multiply(term, R, w) / n;
+    }
+
+    for (long i = 0; i < j; ++i) {
+        sum = fixed_multiply(sum, sum, w);
+    }
+
+    const long shift{static_cast<long>(static_cast<long double>(k))};
+
+    return BigFloat::fromMantissa(sum, shift - w, precision);
+}
+
+/**
+ * log:
+ *
+ * Return the natural logarithm of x at the precision of x. Throws
+ * std::domain_error if x <= 0.
+ *
+ * x = y 2^E with 1/sqrt(2) <= y < sqrt(2); log y = 2^(j+1) atanh(z) with
+ * z = (y' - 1)/(y' + 1) and y' = y^(1/2^j), taken by j square roots, and
+ * log x = E log 2 + log y. When |x - 1| < 2^-16, log x is instead summed
+ * directly as d (1 - d/2 + d^2/3 - ...), d = x - 1, which keeps full
+ * relative precision.
+ *
+ * @param x
+ * @return
+ */
+
+BigFloat log(const BigFloat& x) {
+    if (x.isNegative() || x.isZero()) {
+        throw std::domain_error{"log of a non-positive BigFloat."};
+    }
+
+    const int      precision{x.getPrecision()};
+    const HugeInt& m{x.getMantissa()};
+    const long     e{x.getExponent()};
+    const long     length{m.bitLength()};
+
+    if (e < 0 && (e + length == 0 || e + length == 1)) {
+        const HugeInt d{m - power_of_two(-e)};        // (x - 1) 2^-e
+
+        if (d.isZero()) {
+            return BigFloat{0LL, precision};
+        }
+
+        if (e + (d.isNegative() ? -d : d).bitLength() <= -16) {
+            const long    w{precision + 64L};
+            const HugeInt D{signed_shift(d, e + w)};
+            HugeInt       term{power_of_two(w)};
+            HugeInt       factor;
+
+            for (long long i = 1; !term.isZero(); ++i) {
+                factor += term / i;
+                term = -fixed_multiply(term, D, w);
+            }
+
+            return BigFloat::fromMantissa(d * factor, e - w, precision);
+        }
+    }
+
+    const long j{halvings(precision)};
+    const long w{precision + j + 80};
+    const HugeInt one{power_of_two(w)};
+
+    // y in [1/2, 1), doubled if below 1/sqrt(2)
+    long    E{e + length};
+    HugeInt Y{signed_shift(m, w - length)};
+
+    if (2LL * Y * Y < one * one) {
+        Y.shiftLeftBits(1);
+        --E;
+    }
+
+    for (long i = 0; i < j; ++i) {
+        Y = isqrt(signed_shift(Y, w));
+    }
+
+    const HugeInt Z{signed_shift(Y - one, w) / (Y + one)};
+    const HugeInt Z2{fixed_multiply(Z, Z, w)};
+    HugeInt       sum;
+    HugeInt       term{Z};
+
+    for (long long i = 0; !term.isZero(); ++i) {
+        sum += term / (2 * i + 1);
+        term = fixed_multiply(term, Z2, w);
+    }
+
+    const HugeInt logY{signed_shift(sum, j + 1)};
+    const HugeInt logPowerOfTwo{signed_shift(fixed_log2(w + 64)
+                                             * static_cast<long long>(E),
+                                             -64)};
+
+    return BigFloat::fromMantissa(logPowerOfTwo + logY, -w, precision);
+}
+
+/**
+ * sin:
+ *
+ * Return sin x at the precision of x. Throws std::range_error if
+ * |x| >= 2^40.
+ *
+ * @param x
+ * @return
+ */
+
+BigFloat sin(const BigFloat& x) {
+    return sin_cos(x, false);
+}
+
+/**
+ * cos:
+ *
+ * Return cos x at the precision of x. Throws std::range_error if
+ * |x| >= 2^40.
+ *
+ * @param x
+ * @return
+ */
+
+BigFloat cos(const BigFloat& x) {
+    return sin_cos(x, true);
+}
+
+} /* namespace iota */
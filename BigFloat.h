@@ -0,0 +1,137 @@
+/*
+ * BigFloat.h
+ *
+ * Arbitrary-precision binary floating point numbers built on HugeInt.
+ *
+ * A BigFloat holds the value mantissa * 2^exponent, where the mantissa is a
+ * (signed) HugeInt of at most `precision' bits and the exponent a long int.
+ * Each value carries its own precision, chosen by the user between 2 and
+ * maxPrecision bits. Mantissas are kept odd (trailing zero bits are moved
+ * into the exponent), so the cost of an operation is proportional to the
+ * precision of its operands rather than to the full width of a HugeInt.
+ *
+ * add, subtract, multiply, divide and sqrt return the exact result correctly
+ * rounded to the requested precision in any of the four IEEE 754 rounding
+ * modes. The arithmetic operators round to nearest (ties to even) at the
+ * larger of the operands' precisions. Division uses a Newton iteration for
+ * the reciprocal of the divisor, doubling the precision at each step and
+ * truncating the divisor to match, followed by an exact remainder check on
+ * the quotient.
+ *
+ * exp, log, sin and cos are evaluated in fixed point with guard bits, after
+ * argument reduction (by multiples of log 2 or pi/2, then by powers of two),
+ * and return a result at the argument's precision that is faithfully
+ * rounded, i.e., within one unit in the last place, except that sin and cos
+ * lose relative accuracy near their zeros. exp, sin and cos require
+ * |x| < 2^40.
+ *
+ * Conversion to and from decimal strings (scientific notation, e.g.,
+ * "-1.2345e-67") handles up to maxPrecision / 3 significant digits, and is
+ * correctly rounded when the decimal exponent is at most 1000 in magnitude.
+ */
+
+#ifndef BIGFLOAT_H
+#define BIGFLOAT_H
+
+#include "HugeInt.h"
+#include <iosfwd>
+#include <string>
+
+namespace iota {
+
+enum class RoundingMode {
+    nearestEven,
+    towardZero,
+    towardPositive,
+    towardNegative
+};
+
+// default and maximum precisions, in bits of mantissa
+const int defaultPrecision{128};
+const int maxPrecision{4096};
+
+class BigFloat {
+public:
+    BigFloat() = default;
+    BigFloat(long long int, int precision = defaultPrecision);
+    explicit BigFloat(const HugeInt&, int precision = defaultPrecision,
+                      RoundingMode mode = RoundingMode::nearestEven);
+    explicit BigFloat(const char* const, int precision = defaultPrecision,
+                      RoundingMode mode = RoundingMode::nearestEven);
+
+    // mantissa * 2^exponent, rounded to the given precision
+    static BigFloat fromMantissa(const HugeInt&, long, int,
+                            RoundingMode mode = RoundingMode::nearestEven);
+
+    // unary minus operator
+    BigFloat operator-() const;
+
+    // conversions
+    HugeInt toHugeInt(RoundingMode mode = RoundingMode::towardZero) const;
+    explicit operator long double() const;
+
+    // arithmetic, correctly rounded to a given precision
+    friend BigFloat add(const BigFloat&, const BigFloat&, int, RoundingMode);
+    friend BigFloat subtract(const BigFloat&, const BigFloat&, int,
+                             RoundingMode);
+    friend BigFloat multiply(const BigFloat&, const BigFloat&, int,
+                             RoundingMode);
+    friend BigFloat divide(const BigFloat&, const BigFloat&, int,
+                           RoundingMode);
+    friend BigFloat sqrt(const BigFloat&, int, RoundingMode);
+
+    // basic arithmetic (round to nearest at the larger precision)
+    friend BigFloat operator+(const BigFloat&, const BigFloat&);
+    friend BigFloat operator-(const BigFloat&, const BigFloat&);
+    friend BigFloat operator*(const BigFloat&, const BigFloat&);
+    friend BigFloat operator/(const BigFloat&, const BigFloat&);
+
+    BigFloat& operator+=(const BigFloat&);
+    BigFloat& operator-=(const BigFloat&);
+    BigFloat& operator*=(const BigFloat&);
+    BigFloat& operator/=(const BigFloat&);
+
+    // relational operators (exact)
+    friend bool operator==(const BigFloat&, const BigFloat&);
+    friend bool operator!=(const BigFloat&, const BigFloat&);
+    friend bool operator<(const BigFloat&, const BigFloat&);
+    friend bool operator>(const BigFloat&, const BigFloat&);
+    friend bool operator<=(const BigFloat&, const BigFloat&);
+    friend bool operator>=(const BigFloat&, const BigFloat&);
+
+    // input/output
+    std::string toString(int) const;
+    friend std::ostream& operator<<(std::ostream&, const BigFloat&);
+
+    // informational
+    const HugeInt& getMantissa() const;
+    long           getExponent() const;
+    int            getPrecision() const;
+    bool           isZero() const;
+    bool           isNegative() const;
+
+    BigFloat& setPrecision(int, RoundingMode mode = RoundingMode::nearestEven);
+
+private:
+    HugeInt mantissa_;                    // odd, or zero
+    long    exponent_{0};                 // zero if the mantissa is zero
+    int     precision_{defaultPrecision};
+
+    // private utility functions
+    static BigFloat round(const HugeInt&, long, int, RoundingMode,
+                          bool sticky = false);
+    static BigFloat quotient(const HugeInt&, long, const HugeInt&, long, int,
+                             RoundingMode);
+    static int      compare(const BigFloat&, const BigFloat&);
+};
+
+// square root and elementary functions at the argument's precision
+BigFloat sqrt(const BigFloat&);
+BigFloat exp(const BigFloat&);
+BigFloat log(const BigFloat&);
+BigFloat sin(const BigFloat&);
+BigFloat cos(const BigFloat&);
+
+} /* namespace iota */
+
+#endif /* BIGFLOAT_H */
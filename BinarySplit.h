@@ -0,0 +1,241 @@
+/*
+ * BinarySplit.h
+ *
+ * Generic binary splitting for series of the form
+ *
+ *              N-1          p(0) p(1) ... p(n)
+ *         S =  sum  a(n) --------------------
+ *              n=0          q(0) q(1) ... q(n)
+ *
+ * where a(n), p(n) and q(n) are small (word-sized or a few digits) integers.
+ * Over a range of terms [n1, n2) define
+ *
+ *         P(n1, n2) = p(n1) ... p(n2 - 1),    Q(n1, n2) = q(n1) ... q(n2 - 1),
+ *
+ * and T(n1, n2) such that the partial sum over [n1, n2), relative to the
+ * preceding terms, is T(n1, n2) / Q(n1, n2). For a single term,
+ * P = p(n), Q = q(n) and T = a(n) p(n), and two adjacent ranges
+ * [n1, m) and [m, n2) combine as
+ *
+ *         P = P1 P2,    Q = Q1 Q2,    T = T1 Q2 + P1 T2.
+ *
+ * Splitting the range in halves recursively keeps the operands of each
+ * multiplication balanced in size, and S is recovered at the end with a
+ * single division, T(0, N) / Q(0, N).
+ *
+ * The Series type supplies the term recurrence through the member functions
+ *
+ *         HugeInt a(unsigned long n) const;
+ *         HugeInt p(unsigned long n) const;
+ *         HugeInt q(unsigned long n) const;
+ *
+ * The two halves of each range are independent, so the recursion down to
+ * parallelDepth levels runs the left half on a separate thread: up to
+ * 2^parallelDepth ranges are evaluated concurrently.
+ *
+ * WARNING: P, Q and T must all be representable as HugeInts, which limits
+ * the number of terms that can be summed in the default configuration.
+ */
+
+#ifndef BINARYSPLIT_H
+#define BINARYSPLIT_H
+
+#include "HugeInt.h"
+#include <algorithm>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+namespace iota {
+
+template <typename Series>
+class BinarySplit {
+public:
+    // products and scaled partial sum over a range of terms
+    struct Sums {
+        HugeInt P;
+        HugeInt Q;
+        HugeInt T;
+    };
+
+    explicit BinarySplit(const Series&, int parallelDepth = defaultDepth());
+
+    Sums    split(unsigned long, unsigned long) const;
+    HugeInt evaluate(unsigned long, const HugeInt&) const;
+
+    static HugeInt divide(const Sums&, const HugeInt&);
+    static int     defaultDepth();
+
+private:
+    Series series_;
+    int    parallelDepth_;
+
+    // private utility functions
+    Sums split(unsigned long, unsigned long, int) const;
+};
+
+/**
+ * Constructor
+ *
+ * @param series
+ * @param parallelDepth
+ */
+
+template <typename Series>
+BinarySplit<Series>::BinarySplit(const Series& series, int parallelDepth)
+    : series_{series}, parallelDepth_{parallelDepth} {
+}
+
+/**
+ * defaultDepth()
+ *
+ * Return the number of recursion levels to run in parallel by default:
+ * enough that every hardware thread receives at least one range, i.e.,
+ * ceil(log2(hardware threads)).
+ *
+ * @return
+ */
+
+template <typename Series>
+int BinarySplit<Series>::defaultDepth() {
+    const unsigned int threads{std::thread::hardware_concurrency()};
+    int                depth{0};
+
+    while ((1U << depth) < threads) {
+        ++depth;
+    }
+
+    return depth;
+}
+
+/**
+ * split
+ *
+ * Return P, Q and T for the range of terms [first, last). An empty range
+ * (first == last) gives the identity sums P = 1, Q = 1, T = 0; throws
+ * std::invalid_argument if first > last.
+ *
+ * @param first
+ * @param last
+ * @return
+ */
+
+template <typename Series>
+typename BinarySplit<Series>::Sums
+BinarySplit<Series>::split(unsigned long first, unsigned long last) const {
+    if (first > last) {
+        throw std::invalid_argument{"BinarySplit: range has first > last."};
+    }
+
+    return split(first, last, 0);
+}
+
+/**
+ * evaluate
+ *
+ * Return floor(scale * S) for the sum S of the first `terms' terms of the
+ * series (truncation error in S is the caller's responsibility), i.e.,
+ * divide(split(0, terms), scale). For terms == 0 the sum is empty, and the
+ * result is 0.
+ *
+ * @param terms
+ * @param scale
+ * @return
+ */
+
+template <typename Series>
+HugeInt BinarySplit<Series>::evaluate(unsigned long terms,
+                                      const HugeInt& scale) const {
+    return divide(split(0, terms), scale);
+}
+
+/**
+ * divide
+ *
+ * Return scale * T / Q for the sums of a range of terms. T and Q are first
+ * shifted right by a common amount, leaving Q with 64 bits more than the
+ * quotient |scale * T / Q| can have, so that the product scale * T and the
+ * single final division stay no larger than necessary. Each truncation
+ * perturbs the exact quotient by less than 2^-62, so the result differs
+ * from floor(scale * |T / Q|) (with the sign of T / Q) by at most one unit
+ * in either direction; callers should carry guard digits.
+ *
+ * @param sums
+ * @param scale
+ * @return
+ */
+
+template <typename Series>
+HugeInt BinarySplit<Series>::divide(const Sums& sums, const HugeInt& scale) {
+    HugeInt    Q{sums.Q};
+    HugeInt    T{sums.T};
+    const bool negative{T.isNegative() != Q.isNegative()};
+
+    if (T.isNegative()) {
+        T = -T;
+    }
+    if (Q.isNegative()) {
+        Q = -Q;
+    }
+
+    const int excess{Q.bitLength() - scale.bitLength()
+                     - std::max(0, T.bitLength() - Q.bitLength()) - 64};
+    if (excess > 0) {
+        T.shiftRightBits(excess);
+        Q.shiftRightBits(excess);
+    }
+
+    const HugeInt result{T * scale / Q};
+
+    return negative ? -result : result;
+}
+
+/**
+ * split: (private utility function)
+ *
+ * Recursive binary splitting of [first, last), first <= last. Ranges at
+ * recursion depth less than parallelDepth_ evaluate their left half
+ * asynchronously.
+ *
+ * @param first
+ * @param last
+ * @param depth
+ * @return
+ */
+
+template <typename Series>
+typename BinarySplit<Series>::Sums
+BinarySplit<Series>::split(unsigned long first, unsigned long last,
+                           int depth) const {
+    if (first == last) {
+        return Sums{1LL, 1LL, 0LL};
+    }
+
+    if (last - first == 1) {
+        const HugeInt p{series_.p(first)};
+        return Sums{p, series_.q(first), series_.a(first) * p};
+    }
+
+    const unsigned long middle{first + (last - first) / 2};
+    Sums                left;
+    Sums                right;
+
+    if (depth < parallelDepth_) {
+        auto future = std::async(std::launch::async, [&] {
+            return split(first, middle, depth + 1);
+        });
+        right = split(middle, last, depth + 1);
+        left = future.get();
+    }
+    else {
+        left = split(first, middle, depth + 1);
+        right = split(middle, last, depth + 1);
+    }
+
+    return Sums{left.P * right.P, left.Q * right.Q,
+                left.T * right.Q + left.P * right.T};
+}
+
+} /* namespace iota */
+
+#endif /* BINARYSPLIT_H */
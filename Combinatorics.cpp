@@ -0,0 +1,464 @@
+/*
+ * Combinatorics.cpp
+ *
+ * Implementation of the combinatorial functions declared in
+ * Combinatorics.h.
+ *
+ */
+
+#include "Combinatorics.h"
+#include "Montgomery.h"
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+/*
+ * Non-member utility functions (in anonymous namespace -- file scope only).
+ *
+ */
+
+namespace { /* anonymous namespace */
+
+/*
+ * Return the primes p <= n, using a sieve of Eratosthenes.
+ *
+ */
+
+std::vector<std::uint32_t> primes_up_to(unsigned int n) {
+    std::vector<std::uint32_t> primes;
+    std::vector<bool>          composite(n + 1, false);
+
+    for (std::uint64_t p = 2; p <= n; ++p) {
+        if (!composite[p]) {
+            primes.push_back(static_cast<std::uint32_t>(p));
+            for (std::uint64_t q = p * p; q <= n; q += p) {
+                composite[q] = true;
+            }
+        }
+    }
+
+    return primes;
+}
+
+/*
+ * Return the exponent of the prime p in n! (Legendre's formula),
+ * sum_k floor(n / p^k).
+ *
+ */
+
+unsigned int legendre_exponent(unsigned int n, unsigned int p) {
+    unsigned int e{0};
+
+    while (n > 0) {
+        n /= p;
+        e += n;
+    }
+
+    return e;
+}
+
+/*
+ * Return the product of the values in [first, last) by recursive halving, so
+ * that both operands of each multiplication are products of (nearly) equal
+ * numbers of leaves.
+ *
+ */
+
+iota::HugeInt product_tree(const std::vector<iota::HugeInt>& values,
+                           std::size_t first, std::size_t last) {
+    if (last - first == 0) {
+        return 1LL;
+    }
+
+    if (last - first == 1) {
+        return values[first];
+    }
+
+    const std::size_t middle{first + (last - first) / 2};
+
+    return product_tree(values, first, middle)
+         * product_tree(values, middle, last);
+}
+
+/*
+ * Return the product of a list of word-sized factors. Consecutive factors
+ * are first packed into words below 2^62 (one HugeInt leaf per word), then
+ * the leaves are multiplied in a balanced product tree.
+ *
+ */
+
+iota::HugeInt product_of(const std::vector<std::uint32_t>& factors) {
+    const std::uint64_t        wordLimit{1ULL << 62};
+    std::vector<iota::HugeInt> leaves;
+    std::uint64_t              word{1};
+
+    for (std::uint32_t f : factors) {
+        if (word > wordLimit / f) {
+            leaves.push_back(static_cast<long long>(word));
+            word = 1;
+        }
+        word *= f;
+    }
+    leaves.push_back(static_cast<long long>(word));
+
+    return product_tree(leaves, 0, leaves.size());
+}
+
+/*
+ * Return the odd part of the swinging factorial n!/(floor(n/2)!)^2. The
+ * exponent of the odd prime p in the swinging factorial is
+ * sum_k (floor(n / p^k) mod 2), which is 1 for n/2 < p <= n, 0 for
+ * n/3 < p <= n/2, and (floor(n/p) mod 2) for sqrt(n) < p <= n/3.
+ *
+ */
+
+iota::HugeInt odd_swing(unsigned int n,
+                        const std::vector<std::uint32_t>& primes) {
+    std::vector<std::uint32_t> factors;
+
+    for (std::size_t i = 1; i < primes.size() && primes[i] <= n; ++i) {
+        const std::uint32_t p{primes[i]};
+
+        if (p > n / 2) {
+            factors.push_back(p);
+        }
+        else if (p > n / 3) {
+            continue;
+        }
+        else if (static_cast<std::uint64_t>(p) * p > n) {
+            if ((n / p) & 1) {
+                factors.push_back(p);
+            }
+        }
+        else {
+            for (unsigned int q = n / p; q > 0; q /= p) {
+                if (q & 1) {
+                    factors.push_back(p);
+                }
+            }
+        }
+    }
+
+    return product_of(factors);
+}
+
+/*
+ * Return the odd part of n!, using n! = (floor(n/2)!)^2 * swing(n).
+ *
+ */
+
+iota::HugeInt odd_factorial(unsigned int n,
+                            const std::vector<std::uint32_t>& primes) {
+    if (n < 2) {
+        return 1LL;
+    }
+
+    const iota::HugeInt half{odd_factorial(n / 2, primes)};
+
+    return half * half * odd_swing(n, primes);
+}
+
+/*
+ * Arithmetic policies for fibonacci_pair: ordinary integers, residues modulo
+ * an even m (reduced with operator%), and residues modulo an odd m in
+ * Montgomery form.
+ *
+ */
+
+struct IntegerRing {
+    iota::HugeInt zero() const { return 0LL; }
+    iota::HugeInt one() const { return 1LL; }
+    iota::HugeInt add(const iota::HugeInt& a, const iota::HugeInt& b) const {
+        return a + b;
+    }
+    iota::HugeInt subtract(const iota::HugeInt& a,
+                           const iota::HugeInt& b) const {
+        return a - b;
+    }
+    iota::HugeInt multiply(const iota::HugeInt& a,
+                           const iota::HugeInt& b) const {
+        return a * b;
+    }
+};
+
+struct ModularRing {
+    const iota::HugeInt& m;
+
+    iota::HugeInt zero() const { return 0LL; }
+    iota::HugeInt one() const { return 1LL; }
+    iota::HugeInt add(const iota::HugeInt& a, const iota::HugeInt& b) const {
+        iota::HugeInt sum{a + b};
+        return sum >= m ? sum - m : sum;
+    }
+    iota::HugeInt subtract(const iota::HugeInt& a,
+                           const iota::HugeInt& b) const {
+        iota::HugeInt difference{a - b};
+        return difference.isNegative() ? difference + m : difference;
+    }
+    iota::HugeInt multiply(const iota::HugeInt& a,
+                           const iota::HugeInt& b) const {
+        return a * b % m;
+    }
+};
+
+struct MontgomeryRing {
+    const iota::Montgomery& mont;
+
+    iota::HugeInt zero() const { return 0LL; }
+    iota::HugeInt one() const { return mont.one(); }
+    iota::HugeInt add(const iota::HugeInt& a, const iota::HugeInt& b) const {
+        return mont.add(a, b);
+    }
+    iota::HugeInt subtract(const iota::HugeInt& a,
+                           const iota::HugeInt& b) const {
+        return mont.subtract(a, b);
+    }
+    iota::HugeInt multiply(const iota::HugeInt& a,
+                           const iota::HugeInt& b) const {
+        return mont.multiply(a, b);
+    }
+};
+
+/*
+ * Return (F(n), F(n+1)) for n >= 0 by fast doubling, scanning the bits of n
+ * from the most significant: (F(k), F(k+1)) becomes (F(2k), F(2k+1)), or
+ * (F(2k+1), F(2k+2)) if the next bit is set.
+ *
+ */
+
+template <typename Ring>
+std::pair<iota::HugeInt, iota::HugeInt> fibonacci_pair(const Ring& ring,
+                                                       const iota::HugeInt& n) {
+    iota::HugeInt a{ring.zero()};     // F(k)
+    iota::HugeInt b{ring.one()};      // F(k+1)
+
+    for (int i = n.bitLength() - 1; i >= 0; --i) {
+        const iota::HugeInt twoBminusA{ring.subtract(ring.add(b, b), a)};
+        const iota::HugeInt c{ring.multiply(a, twoBminusA)};
+        const iota::HugeInt d{ring.add(ring.multiply(a, a),
+                                       ring.multiply(b, b))};
+
+        iota::HugeInt bit{n};
+        if (bit.shiftRightBits(i).shortModulo(2) == 1) {
+            a = d;
+            b = ring.add(c, d);
+        }
+        else {
+            a = c;
+            b = d;
+        }
+    }
+
+    return {a, b};
+}
+
+} /* anonymous namespace */
+
+
+
+namespace iota {
+
+/**
+ * factorial:
+ *
+ * Return n! using Luschny's prime swing algorithm. The odd part of n! is
+ * built recursively from the odd parts of the swinging factorials, each of
+ * which is a product of primes computed in a product tree, and the power
+ * of two, 2^(n - popcount(n)), is applied at the end as a single shift.
+ *
+ * @param n
+ * @return
+ */
+
+HugeInt factorial(unsigned int n) {
+    const std::vector<std::uint32_t> primes{primes_up_to(n)};
+
+    unsigned int popcount{0};
+    for (unsigned int m = n; m != 0; m >>= 1) {
+        popcount += m & 1;
+    }
+
+    return odd_factorial(n, primes).shiftLeftBits(n - popcount);
+}
+
+/**
+ * double_factorial:
+ *
+ * Return n!! = n (n - 2) (n - 4) ... For even n = 2k this is 2^k k!. For odd
+ * n = 2k + 1, n!! = n! / (2^k k!), so the exponent of each odd prime p in
+ * n!! is the difference of its Legendre exponents in n! and k!, and n!! is
+ * formed directly as a product of prime powers, without division.
+ *
+ * @param n
+ * @return
+ */
+
+HugeInt double_factorial(unsigned int n) {
+    if (n % 2 == 0) {
+        return factorial(n / 2).shiftLeftBits(n / 2);
+    }
+
+    const unsigned int k{n / 2};
+    std::vector<std::uint32_t> factors;
+
+    for (std::uint32_t p : primes_up_to(n)) {
+        if (p == 2) {
+            continue;
+        }
+
+        const unsigned int e{legendre_exponent(n, p) - legendre_exponent(k, p)};
+        factors.insert(factors.end(), e, p);
+    }
+
+    return product_of(factors);
+}
+
+/**
+ * primorial:
+ *
+ * Return n#, the product of the primes p <= n.
+ *
+ * @param n
+ * @return
+ */
+
+HugeInt primorial(unsigned int n) {
+    return product_of(primes_up_to(n));
+}
+
+/**
+ * binomial:
+ *
+ * Return the binomial coefficient C(n, k) = n! / (k! (n - k)!), which is 0
+ * for k > n. The exponent of each prime p <= n in C(n, k) is
+ * L(n) - L(k) - L(n - k), with L the Legendre exponent; by Kummer's theorem
+ * this is the number of carries when k and n - k are added in base p, so
+ * it is at most 1 for p > sqrt(n), where it reduces to the single test
+ * n mod p < k mod p. The prime powers are multiplied in a product tree.
+ *
+ * @param n
+ * @param k
+ * @return
+ */
+
+HugeInt binomial(unsigned int n, unsigned int k) {
+    if (k > n) {
+        return 0LL;
+    }
+
+    if (k > n - k) {
+        k = n - k;
+    }
+
+    std::vector<std::uint32_t> factors;
+
+    for (std::uint32_t p : primes_up_to(n)) {
+        if (static_cast<std::uint64_t>(p) * p > n) {
+            if (n % p < k % p) {
+                factors.push_back(p);
+            }
+            continue;
+        }
+
+        const unsigned int e{legendre_exponent(n, p) - legendre_exponent(k, p)
+                             - legendre_exponent(n - k, p)};
+        factors.insert(factors.end(), e, p);
+    }
+
+    return product_of(factors);
+}
+
+/**
+ * multinomial:
+ *
+ * Return the multinomial coefficient (k_1 + ... + k_m)! / (k_1! ... k_m!),
+ * from the Legendre exponents of the primes up to n = k_1 + ... + k_m, as
+ * for binomial.
+ *
+ * @param k
+ * @return
+ */
+
+HugeInt multinomial(const std::vector<unsigned int>& k) {
+    unsigned int n{0};
+    for (unsigned int ki : k) {
+        n += ki;
+    }
+
+    std::vector<std::uint32_t> factors;
+
+    for (std::uint32_t p : primes_up_to(n)) {
+        unsigned int e{legendre_exponent(n, p)};
+        for (unsigned int ki : k) {
+            e -= legendre_exponent(ki, p);
+        }
+        factors.insert(factors.end(), e, p);
+    }
+
+    return product_of(factors);
+}
+
+/**
+ * fibonacci:
+ *
+ * Return the n'th Fibonacci number F(n), with F(0) = 0, F(1) = 1, by fast
+ * doubling.
+ *
+ * @param n
+ * @return
+ */
+
+HugeInt fibonacci(unsigned int n) {
+    return fibonacci_pair(IntegerRing{}, static_cast<long long>(n)).first;
+}
+
+/**
+ * lucas:
+ *
+ * Return the n'th Lucas number L(n), with L(0) = 2, L(1) = 1, using
+ * L(n) = 2 F(n+1) - F(n).
+ *
+ * @param n
+ * @return
+ */
+
+HugeInt lucas(unsigned int n) {
+    const auto fib = fibonacci_pair(IntegerRing{}, static_cast<long long>(n));
+
+    return fib.second + fib.second - fib.first;
+}
+
+/**
+ * fibonacci_mod:
+ *
+ * Return F(n) mod m, 0 <= result < m, for n >= 0 and m > 0, by fast
+ * doubling on residues. An odd modulus uses Montgomery multiplication; an
+ * even modulus reduces with operator%, and requires m^2 to be representable
+ * as a HugeInt.
+ *
+ * @param n
+ * @param m
+ * @return
+ */
+
+HugeInt fibonacci_mod(const HugeInt& n, const HugeInt& m) {
+    if (n.isNegative() || m.isNegative() || m.isZero()) {
+        throw std::domain_error{"fibonacci_mod requires n >= 0 and m > 0."};
+    }
+
+    if (m == 1LL) {
+        return 0LL;
+    }
+
+    if (m.shortModulo(2) == 1) {
+        const Montgomery mont{m};
+        const auto fib = fibonacci_pair(MontgomeryRing{mont}, n);
+        return mont.fromMontgomery(fib.first);
+    }
+
+    return fibonacci_pair(ModularRing{m}, n).first;
+}
+
+} /* namespace iota */
@@ -0,0 +1,50 @@
+/*
+ * Combinatorics.h
+ *
+ * Combinatorial functions returning HugeInts.
+ *
+ * The factorial family is computed from prime factorizations rather than by
+ * successive multiplication: the prime factors are packed into machine
+ * words and multiplied together in a balanced product tree, so that the
+ * operands of each HugeInt multiplication are of similar size, and powers
+ * of two are applied as a single final shift. Binomial and multinomial
+ * coefficients are built in the same way from the prime exponents given by
+ * Legendre's formula, without forming any factorial or dividing.
+ *
+ * Fibonacci and Lucas numbers use the fast doubling identities
+ *
+ *     F(2k) = F(k) (2 F(k+1) - F(k)),    F(2k+1) = F(k)^2 + F(k+1)^2,
+ *
+ * which need O(log n) multiplications instead of n additions.
+ *
+ * As with the arithmetic operators, results that exceed the capacity of a
+ * HugeInt are silently truncated; e.g., factorial(n) is representable for
+ * n <= 1100 and fibonacci(n) for n <= 13000 in the default configuration
+ * (fibonacci_mod has no such limit on n).
+ */
+
+#ifndef COMBINATORICS_H
+#define COMBINATORICS_H
+
+#include "HugeInt.h"
+#include <vector>
+
+namespace iota {
+
+// factorials and related products
+HugeInt factorial(unsigned int);
+HugeInt double_factorial(unsigned int);
+HugeInt primorial(unsigned int);
+
+// binomial and multinomial coefficients
+HugeInt binomial(unsigned int, unsigned int);
+HugeInt multinomial(const std::vector<unsigned int>&);
+
+// Fibonacci and Lucas numbers
+HugeInt fibonacci(unsigned int);
+HugeInt lucas(unsigned int);
+HugeInt fibonacci_mod(const HugeInt&, const HugeInt&);
+
+} /* namespace iota */
+
+#endif /* COMBINATORICS_H */
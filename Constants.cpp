@@ -0,0 +1,263 @@
+/*
+ * Constants.cpp
+ *
+ * Implementation of the mathematical constants declared in Constants.h.
+ *
+ */
+
+#include "Constants.h"
+#include "BinarySplit.h"
+#include "NumberTheory.h"
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+
+/*
+ * Non-member utility functions (in anonymous namespace -- file scope only).
+ *
+ */
+
+namespace { /* anonymous namespace */
+
+using Clock = std::chrono::steady_clock;
+
+/*
+ * Return the number of seconds elapsed since start.
+ *
+ */
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/*
+ * Return 10^n.
+ *
+ */
+
+iota::HugeInt power_of_ten(unsigned int n) {
+    const std::string digits{"1" + std::string(n, '0')};
+
+    return iota::HugeInt{digits.c_str()};
+}
+
+/*
+ * Throw std::invalid_argument if a constant cannot be computed to the given
+ * number of decimal places.
+ *
+ */
+
+void check_digits(unsigned int digits, const char* const name) {
+    if (digits > iota::maxConstantDigits) {
+        throw std::invalid_argument{std::string{name}
+                                    + ": too many digits for a HugeInt."};
+    }
+}
+
+/*
+ * Terms of the Chudnovsky series, in the form required by BinarySplit:
+ *
+ *     p(n) = -(6n - 5)(2n - 1)(6n - 1),    q(n) = n^3 640320^3 / 24,
+ *     a(n) = 13591409 + 545140134 n,       p(0) = q(0) = 1.
+ *
+ */
+
+struct ChudnovskySeries {
+    iota::HugeInt a(unsigned long n) const {
+        return 13591409LL + 545140134LL * static_cast<long long>(n);
+    }
+
+    iota::HugeInt p(unsigned long n) const {
+        if (n == 0) {
+            return 1LL;
+        }
+
+        const long long k{static_cast<long long>(n)};
+
+        return -(6 * k - 5) * (2 * k - 1) * (6 * k - 1);
+    }
+
+    iota::HugeInt q(unsigned long n) const {
+        if (n == 0) {
+            return 1LL;
+        }
+
+        const long long k{static_cast<long long>(n)};
+
+        return iota::HugeInt{k * k * k} * 10939058860032000LL;
+    }
+};
+
+/*
+ * Terms of the series e = sum 1/n!: p(n) = a(n) = 1, q(n) = n, q(0) = 1.
+ *
+ */
+
+struct ExponentialSeries {
+    iota::HugeInt a(unsigned long) const {
+        return 1LL;
+    }
+
+    iota::HugeInt p(unsigned long) const {
+        return 1LL;
+    }
+
+    iota::HugeInt q(unsigned long n) const {
+        return n == 0 ? 1LL : static_cast<long long>(n);
+    }
+};
+
+} /* anonymous namespace */
+
+
+
+namespace iota {
+
+/**
+ * compute_pi:
+ *
+ * Return floor(pi * 10^digits), computed from the Chudnovsky series with
+ * guardDigits extra digits. Summing the series S = T/Q by binary splitting,
+ *
+ *     pi * 10^d = 426880 sqrt(10005 * 10^(2d)) Q / T.
+ *
+ * @param digits
+ * @param timings
+ * @return
+ */
+
+HugeInt compute_pi(unsigned int digits, PhaseTimings* const timings) {
+    check_digits(digits, "compute_pi");
+
+    using Splitter = BinarySplit<ChudnovskySeries>;
+
+    const unsigned int  precision{digits + guardDigits};
+    const unsigned long terms{precision / 14 + 2};
+    const HugeInt       scale{power_of_ten(precision)};
+    const Splitter      splitter{ChudnovskySeries{}};
+
+    Clock::time_point start{Clock::now()};
+    const Splitter::Sums sums{splitter.split(0, terms)};
+    if (timings != nullptr) {
+        timings->splitting += seconds_since(start);
+    }
+
+    start = Clock::now();
+    const HugeInt numerator{426880LL * isqrt(10005LL * scale * scale)};
+    if (timings != nullptr) {
+        timings->sqrt += seconds_since(start);
+    }
+
+    // Q / T is the reciprocal of the series sum, T / Q.
+    start = Clock::now();
+    const HugeInt pi{Splitter::divide(Splitter::Sums{sums.P, sums.T, sums.Q},
+                                      numerator)
+                     / power_of_ten(guardDigits)};
+    if (timings != nullptr) {
+        timings->division += seconds_since(start);
+    }
+
+    return pi;
+}
+
+/**
+ * compute_e:
+ *
+ * Return floor(e * 10^digits), computed from the series sum 1/n! with
+ * guardDigits extra digits, summing terms until n! > 10^(digits + guard).
+ *
+ * @param digits
+ * @param timings
+ * @return
+ */
+
+HugeInt compute_e(unsigned int digits, PhaseTimings* const timings) {
+    check_digits(digits, "compute_e");
+
+    using Splitter = BinarySplit<ExponentialSeries>;
+
+    const unsigned int precision{digits + guardDigits};
+    unsigned long      terms{1};
+
+    for (double log10Factorial = 0.0; log10Factorial <= precision; ++terms) {
+        log10Factorial += std::log10(static_cast<double>(terms));
+    }
+
+    const Splitter splitter{ExponentialSeries{}};
+
+    Clock::time_point start{Clock::now()};
+    const Splitter::Sums sums{splitter.split(0, terms)};
+    if (timings != nullptr) {
+        timings->splitting += seconds_since(start);
+    }
+
+    start = Clock::now();
+    const HugeInt e{Splitter::divide(sums, power_of_ten(precision))
+                    / power_of_ten(guardDigits)};
+    if (timings != nullptr) {
+        timings->division += seconds_since(start);
+    }
+
+    return e;
+}
+
+/**
+ * compute_sqrt2:
+ *
+ * Return floor(sqrt(2) * 10^digits) = isqrt(2 * 10^(2 digits)), which is
+ * exact and needs no guard digits.
+ *
+ * @param digits
+ * @param timings
+ * @return
+ */
+
+HugeInt compute_sqrt2(unsigned int digits, PhaseTimings* const timings) {
+    check_digits(digits, "compute_sqrt2");
+
+    const HugeInt scale{power_of_ten(digits)};
+
+    const Clock::time_point start{Clock::now()};
+    const HugeInt root{isqrt(2LL * scale * scale)};
+    if (timings != nullptr) {
+        timings->sqrt += seconds_since(start);
+    }
+
+    return root;
+}
+
+/**
+ * format_constant:
+ *
+ * Format a non-negative scaled constant, floor(c * 10^digits), as a decimal
+ * fraction with the given number of digits after the decimal point, e.g.,
+ * format_constant(compute_pi(5), 5) returns "3.14159".
+ *
+ * @param scaled
+ * @param digits
+ * @param timings
+ * @return
+ */
+
+std::string format_constant(const HugeInt& scaled, unsigned int digits,
+                            PhaseTimings* const timings) {
+    const Clock::time_point start{Clock::now()};
+    std::string             result{scaled.toDigitString()};
+
+    if (result.size() <= digits) {
+        result.insert(0, digits + 1 - result.size(), '0');
+    }
+    if (digits > 0) {
+        result.insert(result.size() - digits, 1, '.');
+    }
+
+    if (timings != nullptr) {
+        timings->conversion += seconds_since(start);
+    }
+
+    return result;
+}
+
+} /* namespace iota */
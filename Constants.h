@@ -0,0 +1,60 @@
+/*
+ * Constants.h
+ *
+ * Mathematical constants to a given number of decimal places, returned as
+ * scaled integers: compute_pi(d) returns floor(pi * 10^d), and so on.
+ *
+ * pi is computed from the Chudnovsky series
+ *
+ *            1      12   inf   (-1)^n (6n)! (13591409 + 545140134 n)
+ *          ---- = ------ sum  ----------------------------------------
+ *           pi    640320^(3/2)  n=0      (3n)! (n!)^3 640320^(3n)
+ *
+ * (about 14.18 digits per term) summed by binary splitting (BinarySplit.h),
+ * followed by one integer square root for sqrt(10005) and one division.
+ * e is the series sum 1/n!, also by binary splitting, and sqrt(2) a single
+ * integer square root, floor(sqrt(2 * 10^(2d))).
+ *
+ * The series results are computed with guardDigits extra digits and then
+ * truncated, so the last digit is wrong only if the true expansion has a
+ * run of guardDigits nines or zeros at that point. Every intermediate value
+ * must be representable as a HugeInt, which limits the number of digits to
+ * maxConstantDigits; std::invalid_argument is thrown beyond it.
+ *
+ * If timings is not a nullptr, the wall-clock time in seconds spent in each
+ * phase (binary splitting, the final division, the square root and, in
+ * format_constant, decimal conversion) is added to it.
+ */
+
+#ifndef CONSTANTS_H
+#define CONSTANTS_H
+
+#include "HugeInt.h"
+#include <string>
+
+namespace iota {
+
+// extra decimal digits carried by the series evaluations
+const unsigned int guardDigits{10};
+
+// largest number of decimal places for which the constants are representable
+const unsigned int maxConstantDigits{1400};
+
+// wall-clock seconds spent in each phase of a computation
+struct PhaseTimings {
+    double splitting{0.0};
+    double division{0.0};
+    double sqrt{0.0};
+    double conversion{0.0};
+};
+
+HugeInt compute_pi(unsigned int, PhaseTimings* const timings = nullptr);
+HugeInt compute_e(unsigned int, PhaseTimings* const timings = nullptr);
+HugeInt compute_sqrt2(unsigned int, PhaseTimings* const timings = nullptr);
+
+std::string format_constant(const HugeInt&, unsigned int,
+                            PhaseTimings* const timings = nullptr);
+
+} /* namespace iota */
+
+#endif /* CONSTANTS_H */
@@ -0,0 +1,348 @@
+/*
+ * DiscreteLog.cpp
+ *
+ * Implementation of discrete_log. See comments in DiscreteLog.h for
+ * details.
+ *
+ */
+
+#include "DiscreteLog.h"
+#include "Montgomery.h"
+#include "NumberTheory.h"
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+
+/*
+ * Non-member utility functions (in anonymous namespace -- file scope only).
+ *
+ */
+
+namespace { /* anonymous namespace */
+
+/*
+ * Return a 32-bit fingerprint of the residue x: its remainder modulo the
+ * largest prime below 2^32, which depends on every digit of x.
+ *
+ */
+
+inline std::uint32_t fingerprint(const iota::HugeInt& x) {
+    return x.shortModulo(4294967291U);
+}
+
+/*
+ * Open-addressing hash table mapping residue fingerprints to baby-step
+ * indices. Distinct residues may share a fingerprint, so lookups report
+ * every index stored under a fingerprint and leave it to the caller to
+ * confirm the match.
+ *
+ */
+
+class FingerprintTable {
+public:
+    explicit FingerprintTable(std::size_t entries) {
+        std::size_t capacity{2};
+        while (capacity < 2 * entries) {
+            capacity *= 2;
+        }
+
+        slots_.assign(capacity, Slot{0, emptySlot});
+        mask_ = capacity - 1;
+    }
+
+    void insert(std::uint32_t key, std::uint32_t index) {
+        std::size_t i{hash(key)};
+        while (slots_[i].index != emptySlot) {
+            i = (i + 1) & mask_;
+        }
+
+        slots_[i] = Slot{key, index};
+    }
+
+    // Call accept(index) for each index stored under key until it returns
+    // true; return whether any call did.
+    template <typename Accept>
+    bool find(std::uint32_t key, Accept accept) const {
+        for (std::size_t i = hash(key); slots_[i].index != emptySlot;
+             i = (i + 1) & mask_) {
+            if (slots_[i].key == key && accept(slots_[i].index)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+private:
+    struct Slot {
+        std::uint32_t key;
+        std::uint32_t index;
+    };
+
+    static const std::uint32_t emptySlot{0xffffffffU};
+
+    std::vector<Slot> slots_;
+    std::size_t       mask_;
+
+    std::size_t hash(std::uint32_t key) const {
+        return (key * 2654435769U) & mask_;   // Fibonacci hashing
+    }
+};
+
+/*
+ * Baby-step giant-step: find x, 0 <= x < q, with gamma^x = beta, where
+ * gamma has order q and m = ceil(sqrt(q)) baby steps gamma^j are tabulated
+ * by fingerprint. Return false if beta is not a power of gamma.
+ *
+ */
+
+bool baby_step_giant_step(const iota::Montgomery& mont,
+                          const iota::HugeInt& gamma, const iota::HugeInt& beta,
+                          const iota::HugeInt& q, std::uint32_t m,
+                          iota::HugeInt* x) {
+    FingerprintTable table{m};
+    iota::HugeInt    babyStep{mont.one()};
+
+    for (std::uint32_t j = 0; j < m; ++j) {
+        if (babyStep == beta) {
+            *x = static_cast<long long>(j);
+            return true;
+        }
+        table.insert(fingerprint(babyStep), j);
+        babyStep = mont.multiply(babyStep, gamma);
+    }
+
+    // giant steps: beta gamma^(-im), i = 0, 1, ..., m - 1, since m^2 >= q
+    const iota::HugeInt giantStep{mont.power(gamma, q - (m % q))};
+    iota::HugeInt       y{beta};
+
+    for (std::uint64_t i = 0; i < m; ++i) {
+        const bool found = table.find(fingerprint(y), [&](std::uint32_t j) {
+            if (mont.power(gamma, static_cast<long long>(j)) != y) {
+                return false;                   // fingerprint collision
+            }
+            *x = static_cast<long long>(i * m + j);
+            return true;
+        });
+
+        if (found) {
+            return true;
+        }
+
+        y = mont.multiply(y, giantStep);
+    }
+
+    return false;
+}
+
+/*
+ * Pollard's rho method for logarithms: find x with gamma^x = beta, where
+ * gamma has prime order q. The walk y = gamma^a beta^b is partitioned into
+ * three classes by fingerprint (multiply by gamma, square, multiply by beta)
+ * and a collision found with Floyd's cycle detection gives
+ * a + b x = A + B x (mod q). Each attempt starts from a different gamma^a,
+ * and the candidate is confirmed before being returned. Return false if no
+ * attempt succeeds, e.g., because beta is not a power of gamma.
+ *
+ */
+
+bool pollard_rho_log(const iota::Montgomery& mont, const iota::HugeInt& gamma,
+                     const iota::HugeInt& beta, const iota::HugeInt& q,
+                     iota::HugeInt* x) {
+    struct Walk {
+        iota::HugeInt y;
+        iota::HugeInt a;
+        iota::HugeInt b;
+    };
+
+    auto step = [&](Walk& w) {
+        switch (fingerprint(w.y) % 3) {
+        case 0:
+            w.y = mont.multiply(w.y, gamma);
+            w.a = (w.a + 1LL) % q;
+            break;
+        case 1:
+            w.y = mont.square(w.y);
+            w.a = (w.a + w.a) % q;
+            w.b = (w.b + w.b) % q;
+            break;
+        default:
+            w.y = mont.multiply(w.y, beta);
+            w.b = (w.b + 1LL) % q;
+            break;
+        }
+    };
+
+    const int maxAttempts{16};
+
+    for (long long attempt = 1; attempt <= maxAttempts; ++attempt) {
+        const iota::HugeInt a0{iota::HugeInt{attempt} % q};
+        Walk tortoise{mont.multiply(mont.power(gamma, a0), beta), a0, 1LL};
+        Walk hare{tortoise};
+
+        do {
+            step(tortoise);
+            step(hare);
+            step(hare);
+        } while (tortoise.y != hare.y);
+
+        // a + b x = A + B x  =>  x = (a - A) / (B - b) (mod q)
+        iota::HugeInt r{(hare.b - tortoise.b) % q};
+        if (r.isNegative()) {
+            r += q;
+        }
+        if (r.isZero()) {
+            continue;
+        }
+
+        iota::HugeInt candidate{(tortoise.a - hare.a) % q * iota::invmod(r, q)
+                                % q};
+        if (candidate.isNegative()) {
+            candidate += q;
+        }
+
+        if (mont.power(gamma, candidate) == beta) {
+            *x = candidate;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+ * Logarithm of beta to the base gamma, of prime order q, choosing between
+ * baby-step giant-step and Pollard's rho according to the table bound.
+ *
+ */
+
+iota::HugeInt subgroup_log(const iota::Montgomery& mont,
+                           const iota::HugeInt& gamma, const iota::HugeInt& beta,
+                           const iota::HugeInt& q, std::size_t maxTableEntries) {
+    iota::HugeInt x;
+    iota::HugeInt m{iota::isqrt(q - 1LL) + 1LL};  // ceil(sqrt(q))
+    bool          found;
+
+    if (m <= static_cast<long long>(maxTableEntries) && m < 0xffffffffLL) {
+        found = baby_step_giant_step(mont, gamma, beta, q,
+                    static_cast<std::uint32_t>(static_cast<long double>(m)), &x);
+    }
+    else {
+        found = pollard_rho_log(mont, gamma, beta, q, &x);
+    }
+
+    if (!found) {
+        throw std::domain_error{"discrete_log: h is not a power of g."};
+    }
+
+    return x;
+}
+
+} /* anonymous namespace */
+
+
+
+namespace iota {
+
+/**
+ * discrete_log:
+ *
+ * Return the least x >= 0 such that g^x = h (mod p), for a prime p and
+ * g, h not divisible by p. Throws std::domain_error if h is not a power of
+ * g. At most maxTableEntries baby steps are stored by any one
+ * baby-step giant-step search.
+ *
+ * With n = q_1^e_1 ... q_k^e_k the order of g, the logarithm modulo each
+ * q^e is found (Pohlig-Hellman) from g' = g^(n/q^e), h' = h^(n/q^e) one
+ * base-q digit at a time, each digit being a logarithm to the base
+ * gamma = g'^(q^(e-1)) of order q. The residues are combined with crt.
+ *
+ * @param g
+ * @param h
+ * @param p
+ * @param maxTableEntries
+ * @return
+ */
+
+HugeInt discrete_log(const HugeInt& g, const HugeInt& h, const HugeInt& p,
+                     std::size_t maxTableEntries) {
+    if (p.isNegative() || p < 2LL) {
+        throw std::domain_error{"discrete_log requires a prime modulus."};
+    }
+
+    if (g % p == 0LL || h % p == 0LL) {
+        throw std::domain_error{"discrete_log of a multiple of p."};
+    }
+
+    if (p == 2LL) {
+        return 0LL;
+    }
+
+    const Montgomery mont{p};
+    const HugeInt    gm{mont.toMontgomery(g)};
+    const HugeInt    hm{mont.toMontgomery(h)};
+
+    // Order of g, and its factorization, from that of p - 1.
+    HugeInt order{p - 1LL};
+    auto    factors = factorize(order);
+
+    for (auto& factor : factors) {
+        while (factor.second > 0) {
+            const HugeInt candidate{divexact(order, factor.first)};
+            if (mont.power(gm, candidate) != mont.one()) {
+                break;
+            }
+            order = candidate;
+            --factor.second;
+        }
+    }
+
+    std::vector<HugeInt> residues;
+    std::vector<HugeInt> moduli;
+
+    for (const auto& factor : factors) {
+        const HugeInt& q{factor.first};
+        const int      e{factor.second};
+
+        if (e == 0) {
+            continue;
+        }
+
+        HugeInt qe{1LL};
+        for (int i = 0; i < e; ++i) {
+            qe *= q;
+        }
+
+        const HugeInt cofactor{divexact(order, qe)};
+        const HugeInt gi{mont.power(gm, cofactor)};
+        const HugeInt hi{mont.power(hm, cofactor)};
+        const HugeInt gamma{mont.power(gi, divexact(qe, q))};
+
+        // x_i = d_0 + d_1 q + ... + d_(e-1) q^(e-1), one digit per pass:
+        // d_k = log_gamma (g'^(-x_i) h')^(q^(e-1-k))
+        HugeInt xi{0LL};
+        HugeInt qk{1LL};
+
+        for (int k = 0; k < e; ++k) {
+            const HugeInt t{mont.multiply(mont.power(gi, (qe - xi) % qe), hi)};
+            const HugeInt beta{mont.power(t, qe / (qk * q))};
+
+            xi += subgroup_log(mont, gamma, beta, q, maxTableEntries) * qk;
+            qk *= q;
+        }
+
+        residues.push_back(xi);
+        moduli.push_back(qe);
+    }
+
+    const HugeInt x{crt(residues, moduli)};
+
+    if (mont.power(gm, x) != hm) {
+        throw std::domain_error{"discrete_log: h is not a power of g."};
+    }
+
+    return x;
+}
+
+} /* namespace iota */
@@ -0,0 +1,38 @@
+/*
+ * DiscreteLog.h
+ *
+ * Discrete logarithms in the multiplicative group modulo a prime p.
+ *
+ * discrete_log(g, h, p) returns the least x >= 0 with g^x = h (mod p). The
+ * order of g is factored (via the factorization of p - 1) and the problem
+ * is split by Pohlig-Hellman into one logarithm per prime power dividing the
+ * order, each solved digit by digit in a subgroup of prime order q, and the
+ * pieces are recombined with the Chinese remainder theorem. This is
+ * efficient when the order of g has only small or moderate prime factors.
+ *
+ * In each prime order subgroup, baby-step giant-step is used when its table
+ * of ceil(sqrt(q)) entries fits within maxTableEntries, and Pollard's rho
+ * method for logarithms (constant memory) otherwise. The table stores only
+ * a 32-bit fingerprint and a 32-bit index per baby step (at most 32 bytes
+ * per entry, counting empty slots), with matches confirmed by recomputing
+ * the candidate power, so memory use is bounded by the configured table
+ * size rather than by the size of the residues.
+ */
+
+#ifndef DISCRETELOG_H
+#define DISCRETELOG_H
+
+#include "HugeInt.h"
+#include <cstddef>
+
+namespace iota {
+
+// default bound on the number of baby steps held in the fingerprint table
+const std::size_t defaultLogTableEntries{1U << 20};
+
+HugeInt discrete_log(const HugeInt&, const HugeInt&, const HugeInt&,
+                     std::size_t maxTableEntries = defaultLogTableEntries);
+
+} /* namespace iota */
+
+#endif /* DISCRETELOG_H */
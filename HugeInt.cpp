@@ -11,12 +11,30 @@
  */
 
 #include "HugeInt.h"
+#include "HugeIntTuning.h"
 #include <cstdlib>   // for abs(), labs(), etc.
 #include <iostream>
 #include <iomanip>
 #include <cstring>
 #include <stdexcept>
 #include <cmath>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <future>
+
+#ifdef HUGEINT_METRICS
+#include "HugeIntMetrics.h"
+#include <chrono>
+
+// time the enclosing operation on operands of the given no. limbs
+#define HUGEINT_MEASURE(operation, limbs) \
+    const OperationTimer operationTimer{iota::HugeIntMetrics::operation, \
+                                        (limbs)}
+#else
+#define HUGEINT_MEASURE(operation, limbs)
+#endif
 
 
 /*
@@ -47,7 +65,526 @@ inline bool is_all_digits(const char *const str) {
         
     return true;
 }
+
+// operands of at least this many digits are multiplied by Karatsuba's method
+std::atomic<int> karatsubaCutoff{iota::tuning::karatsubaCutoff};
+
+// Karatsuba products of at least this many digits may fork sub-products
+const int parallelCutoff{96};
+
+// decimal conversions split values of at least 9*2^k digits concurrently
+const int parallelConversionCutoff{6};
+
+// no. levels of recursion (Karatsuba, decimal conversion) run concurrently
+std::atomic<int> parallelDepth{0};
+
+/*
+ * Return the number of leading zero bits of d > 0.
+ *
+ */
+
+constexpr int leading_zeros(std::uint32_t d) {
+    int n{0};
+    for ( ; (d & 0x80000000U) == 0; d <<= 1, ++n);
+
+    return n;
+}
+
+/*
+ * A single-digit divisor prepared for division by Moller and Granlund's
+ * precomputed reciprocal ("Improved division by invariant integers", 2011):
+ * the divisor normalised by a left shift so that its top bit is set, and
+ * reciprocal = floor((2^64 - 1) / normalised) - 2^32. Each quotient digit
+ * then costs two multiplications and at most two corrections, instead of
+ * a hardware 64/32 division. Constructed at compile time for a constant
+ * divisor (see billion).
+ *
+ */
+
+struct LimbDivisor {
+    constexpr explicit LimbDivisor(std::uint32_t d)
+        : shift{leading_zeros(d)},
+          normalised{d << shift},
+          reciprocal{static_cast<std::uint32_t>(~0ULL / normalised
+                                                - (1ULL << 32))} {}
+
+    int           shift;
+    std::uint32_t normalised;
+    std::uint32_t reciprocal;
+};
+
+// divisor of the 9-digit decimal chunks
+constexpr LimbDivisor billion{1000000000};
+
+/*
+ * Return the quotient of the two-digit number (u1, u0) by the normalised
+ * divisor d, where u1 < d.normalised, and set r to the remainder.
+ *
+ */
+
+inline std::uint32_t divide_2by1(std::uint32_t u1, std::uint32_t u0,
+                                 const LimbDivisor& d, std::uint32_t& r) {
+    const std::uint64_t q{static_cast<std::uint64_t>(d.reciprocal) * u1
+                          + ((static_cast<std::uint64_t>(u1) << 32) | u0)};
+    std::uint32_t       q1{static_cast<std::uint32_t>(q >> 32) + 1};
+    const std::uint32_t q0{static_cast<std::uint32_t>(q)};
+
+    r = u0 - q1 * d.normalised;
+    if (r > q0) {
+        --q1;
+        r += d.normalised;
+    }
+    if (r >= d.normalised) {
+        ++q1;
+        r -= d.normalised;
+    }
+
+    return q1;
+}
+
+/*
+ * Divide u[0 .. n) by d, writing the quotient digits to q[0 .. n) unless q
+ * is a nullptr, and return the remainder. The dividend is shifted left by
+ * d.shift on the fly, which leaves the quotient unchanged and scales the
+ * remainder. q may be u.
+ *
+ */
+
+std::uint32_t divide_digits(const std::uint32_t* u, int n,
+                            const LimbDivisor& d, std::uint32_t* q) {
+    if (n == 0) {
+        return 0;
+    }
+
+    const int     shift{d.shift};
+    std::uint32_t r{static_cast<std::uint32_t>(
+                        static_cast<std::uint64_t>(u[n - 1]) >> (32 - shift))};
+
+    for (int i = n - 1; i > 0; --i) {
+        const std::uint64_t pair{(static_cast<std::uint64_t>(u[i]) << 32)
+                                 | u[i - 1]};
+        const std::uint32_t digit{divide_2by1(r,
+                static_cast<std::uint32_t>(pair >> (32 - shift)), d, r)};
+        if (q != nullptr) {
+            q[i] = digit;
+        }
+    }
+
+    const std::uint32_t digit{divide_2by1(r, u[0] << shift, d, r)};
+    if (q != nullptr) {
+        q[0] = digit;
+    }
+
+    return r >> shift;
+}
+
+/*
+ * Return the reciprocal of the normalised two-digit divisor (d1, d0) for
+ * divide_3by2 (Moller and Granlund, Algorithm 6).
+ *
+ */
+
+std::uint32_t reciprocal_3by2(std::uint32_t d1, std::uint32_t d0) {
+    std::uint32_t v{static_cast<std::uint32_t>(~0ULL / d1 - (1ULL << 32))};
+    std::uint32_t p{d1 * v + d0};
+
+    if (p < d0) {
+        --v;
+        if (p >= d1) {
+            --v;
+            p -= d1;
+        }
+        p -= d1;
+    }
+
+    const std::uint64_t t{static_cast<std::uint64_t>(v) * d0};
+    const std::uint32_t t1{static_cast<std::uint32_t>(t >> 32)};
+    const std::uint32_t t0{static_cast<std::uint32_t>(t)};
+
+    p += t1;
+    if (p < t1) {
+        --v;
+        if (p > d1 || (p == d1 && t0 >= d0)) {
+            --v;
+        }
+    }
+
+    return v;
+}
+
+/*
+ * Return the quotient of the three-digit number (u2, u1, u0) by the
+ * normalised two-digit divisor d = (d1, d0), where (u2, u1) < d and v is
+ * reciprocal_3by2(d1, d0) (Moller and Granlund, Algorithm 5).
+ *
+ */
+
+inline std::uint32_t divide_3by2(std::uint32_t u2, std::uint32_t u1,
+                                 std::uint32_t u0, std::uint32_t d1,
+                                 std::uint32_t d0, std::uint32_t v) {
+    const std::uint64_t d{(static_cast<std::uint64_t>(d1) << 32) | d0};
+    const std::uint64_t q{static_cast<std::uint64_t>(v) * u2
+                          + ((static_cast<std::uint64_t>(u2) << 32) | u1)};
+    std::uint32_t       q1{static_cast<std::uint32_t>(q >> 32)};
+    const std::uint32_t q0{static_cast<std::uint32_t>(q)};
+
+    const std::uint32_t r1{u1 - q1 * d1};
+    std::uint64_t       r{(static_cast<std::uint64_t>(r1) << 32) | u0};
+
+    r -= static_cast<std::uint64_t>(q1) * d0 + d;
+    ++q1;
+
+    if (static_cast<std::uint32_t>(r >> 32) >= q0) {
+        --q1;
+        r += d;
+    }
+    if (r >= d) {
+        ++q1;
+    }
+
+    return q1;
+}
+
+/*
+ * Set r[0 .. na + nb) to the product of a[0 .. na) and b[0 .. nb), by long
+ * multiplication.
+ * 
+ */
+
+void schoolbook_multiply(const std::uint32_t* a, int na, 
+                         const std::uint32_t* b, int nb, std::uint32_t* r) {
+    std::fill(r, r + na + nb, 0);
+    
+    for (int i = 0; i < na; ++i) {
+        const std::uint64_t ai{a[i]};
+        std::uint64_t       partial{0};
+        
+        for (int j = 0; j < nb; ++j) {
+            partial += r[i + j] + ai * b[j];
+            r[i + j] = static_cast<std::uint32_t>(partial);
+            partial >>= 32;
+        }
+        r[i + nb] = static_cast<std::uint32_t>(partial);
+    }
+}
+
+/*
+ * Set r[0 .. 2n) to the square of a[0 .. n). Each cross product a_i a_j, 
+ * i < j, is formed once and the sum of them doubled by a shift, before the 
+ * squares a_i^2 are added on the diagonal, so about half the digit 
+ * products of schoolbook_multiply are needed.
+ * 
+ */
+
+void schoolbook_square(const std::uint32_t* a, int n, std::uint32_t* r) {
+    std::fill(r, r + 2 * n, 0);
+    
+    for (int i = 0; i < n; ++i) {
+        const std::uint64_t ai{a[i]};
+        std::uint64_t       partial{0};
+        
+        for (int j = i + 1; j < n; ++j) {
+            partial += r[i + j] + ai * a[j];
+            r[i + j] = static_cast<std::uint32_t>(partial);
+            partial >>= 32;
+        }
+        r[i + n] = static_cast<std::uint32_t>(partial);
+    }
+    
+    std::uint32_t shifted{0};
+    for (int k = 0; k < 2 * n; ++k) {
+        const std::uint32_t top{r[k] >> 31};
+        r[k] = (r[k] << 1) | shifted;
+        shifted = top;
+    }
+    
+    std::uint64_t carry{0};
+    for (int i = 0; i < n; ++i) {
+        const std::uint64_t square{static_cast<std::uint64_t>(a[i]) * a[i]};
+        
+        carry += r[2 * i] + (square & 0xFFFFFFFFULL);
+        r[2 * i] = static_cast<std::uint32_t>(carry);
+        carry >>= 32;
+        carry += r[2 * i + 1] + (square >> 32);
+        r[2 * i + 1] = static_cast<std::uint32_t>(carry);
+        carry >>= 32;
+    }
+}
+
+/*
+ * Add a[0 .. na) to r[0 .. nr), na <= nr, propagating the carry through r.
+ * Returns the carry out of r.
+ * 
+ */
+
+std::uint32_t digits_add(std::uint32_t* r, int nr, const std::uint32_t* a, 
+                         int na) {
+    std::uint64_t carry{0};
+    int           i{0};
+    
+    for ( ; i < na; ++i) {
+        carry += static_cast<std::uint64_t>(r[i]) + a[i];
+        r[i] = static_cast<std::uint32_t>(carry);
+        carry >>= 32;
+    }
+    
+    for ( ; i < nr && carry != 0; ++i) {
+        carry += r[i];
+        r[i] = static_cast<std::uint32_t>(carry);
+        carry >>= 32;
+    }
+    
+    return static_cast<std::uint32_t>(carry);
+}
+
+/*
+ * Subtract a[0 .. na) from r[0 .. nr), na <= nr, propagating the borrow 
+ * through r.
+ * 
+ */
+
+void digits_subtract(std::uint32_t* r, int nr, const std::uint32_t* a, 
+                     int na) {
+    std::int64_t borrow{0};
+    int          i{0};
+    
+    for ( ; i < na; ++i) {
+        borrow += static_cast<std::int64_t>(r[i]) - a[i];
+        r[i] = static_cast<std::uint32_t>(borrow);
+        borrow >>= 32;
+    }
+    
+    for ( ; i < nr && borrow != 0; ++i) {
+        borrow += r[i];
+        r[i] = static_cast<std::uint32_t>(borrow);
+        borrow >>= 32;
+    }
+}
+
+/*
+ * Return the no. scratch digits needed by karatsuba_multiply for n-digit
+ * operands, with the given cutoff.
+ * 
+ */
+
+int karatsuba_scratch(int n, int cutoff) {
+    if (n < cutoff) {
+        return 0;
+    }
+    
+    const int h{n - n / 2};
+    
+    return 4 * (h + 1) + karatsuba_scratch(h + 1, cutoff);
+}
+
+/*
+ * Return a scratch buffer of at least size digits for karatsuba_multiply. 
+ * The buffer belongs to the calling thread and is reused by its later 
+ * multiplications, so that threads multiplying concurrently share nothing 
+ * and do not allocate once it has grown to their largest product.
+ * 
+ */
+
+std::uint32_t* thread_scratch(int size) {
+    thread_local std::vector<std::uint32_t> scratch;
+    
+    if (static_cast<int>(scratch.size()) < size) {
+        scratch.resize(size);
+    }
+    
+    return scratch.data();
+}
+
+/*
+ * Set r[0 .. 2n) to the product of a[0 .. n) and b[0 .. n), by Karatsuba's
+ * method. With a = a1 B^m + a0 and b = b1 B^m + b0, m = n/2,
+ * 
+ *     ab = z2 B^2m + (z1 - z2 - z0) B^m + z0,
+ * 
+ * where z0 = a0 b0, z2 = a1 b1 and z1 = (a0 + a1)(b0 + b1). z0 and z2 are 
+ * formed in place in the low and high halves of r; the sums a0 + a1 and 
+ * b0 + b1, z1 and the scratch space of the recursion come from scratch, 
+ * which must have karatsuba_scratch(n, cutoff) digits. Operands below 
+ * cutoff digits are multiplied by the schoolbook kernels.
+ * 
+ * If a and b are the same array the product is a square, and so are z0, 
+ * z1 and z2: only one of the sums is formed, and the recursion ends in 
+ * schoolbook_square.
+ * 
+ * The three sub-products are independent. Above parallelCutoff digits, and 
+ * down to parallelDepth levels of recursion, z0 and z2 are formed on 
+ * separate threads, each with a scratch buffer of its own (see 
+ * thread_scratch), while the calling thread forms z1.
+ * 
+ */
+
+void karatsuba_multiply(const std::uint32_t* a, const std::uint32_t* b, int n,
+                        std::uint32_t* r, std::uint32_t* scratch, int depth,
+                        int cutoff) {
+    const bool square{a == b};
+    
+    if (n < cutoff) {
+        if (square) {
+            schoolbook_square(a, n, r);
+        }
+        else {
+            schoolbook_multiply(a, n, b, n, r);
+        }
+        return;
+    }
+    
+    const int      m{n / 2};
+    const int      h{n - m};
+    std::uint32_t* sa{scratch};
+    std::uint32_t* sb{square ? sa : sa + h + 1};
+    std::uint32_t* z1{sa + 2 * h + 2};
+    std::uint32_t* next{z1 + 2 * h + 2};
+    
+    std::copy(a + m, a + n, sa);
+    sa[h] = digits_add(sa, h, a, m);
+    if (!square) {
+        std::copy(b + m, b + n, sb);
+        sb[h] = digits_add(sb, h, b, m);
+    }
+    
+    if (depth < parallelDepth && n >= parallelCutoff) {
+        auto low = std::async(std::launch::async, [&] {
+            karatsuba_multiply(a, b, m, r, 
+                               thread_scratch(karatsuba_scratch(m, cutoff)),
+                               depth + 1, cutoff);
+        });
+        auto high = std::async(std::launch::async, [&] {
+            karatsuba_multiply(a + m, b + m, h, r + 2 * m, 
+                               thread_scratch(karatsuba_scratch(h, cutoff)), 
+                               depth + 1, cutoff);
+        });
+        karatsuba_multiply(sa, sb, h + 1, z1, next, depth + 1, cutoff);
+        low.get();
+        high.get();
+    }
+    else {
+        karatsuba_multiply(a, b, m, r, next, depth + 1, cutoff);
+        karatsuba_multiply(a + m, b + m, h, r + 2 * m, next, depth + 1, cutoff);
+        karatsuba_multiply(sa, sb, h + 1, z1, next, depth + 1, cutoff);
+    }
+    
+    digits_subtract(z1, 2 * h + 2, r, 2 * m);
+    digits_subtract(z1, 2 * h + 2, r + 2 * m, 2 * h);
+    digits_add(r + m, 2 * n - m, z1, 2 * h + 2);
+}
+
+/*
+ * Set r[0 .. na + nb) to the product of a[0 .. na) and b[0 .. nb). Operands 
+ * of equal length are multiplied by Karatsuba's method; for unequal lengths 
+ * the longer operand is cut into pieces the length of the shorter, whose 
+ * products are accumulated into r. Passing the same array as a and b 
+ * selects the squaring kernels. Karatsuba's method is used for operands of 
+ * at least cutoff digits (read once per product by the caller, so that a 
+ * concurrent setKaratsubaCutoff cannot change it part way through).
+ * 
+ */
+
+void multiply_digits(const std::uint32_t* a, int na, const std::uint32_t* b, 
+                     int nb, std::uint32_t* r, int cutoff) {
+    if (na < nb) {
+        std::swap(a, b);
+        std::swap(na, nb);
+    }
+    
+    if (a == b && na == nb && na < cutoff) {
+        schoolbook_square(a, na, r);
+        return;
+    }
+    
+    if (nb < cutoff) {
+        schoolbook_multiply(a, na, b, nb, r);
+        return;
+    }
     
+    if (na == nb) {
+        karatsuba_multiply(a, b, na, r, 
+                           thread_scratch(karatsuba_scratch(na, cutoff)), 0, 
+                           cutoff);
+        return;
+    }
+    
+    std::vector<std::uint32_t> piece(2 * nb);
+    std::fill(r, r + na + nb, 0);
+    
+    for (int offset = 0; offset < na; offset += nb) {
+        const int length{std::min(nb, na - offset)};
+        
+        multiply_digits(a + offset, length, b, nb, piece.data(), cutoff);
+        digits_add(r + offset, na + nb - offset, piece.data(), length + nb);
+    }
+}
+    
+#ifdef HUGEINT_METRICS
+/*
+ * Return the number of limbs in the magnitude of the radix complement
+ * digits[0 .. n): the significant digits, discounting the leading 2^32 - 1
+ * digits of a negative value.
+ *
+ */
+
+int operand_limbs(const std::uint32_t* digits, int n) {
+    const std::uint32_t fill{(digits[n - 1] >> 31) ? 0xFFFFFFFFU : 0};
+    for ( ; n > 1 && digits[n - 1] == fill; --n);
+
+    return n;
+}
+
+/*
+ * Return the greater of the numbers of limbs in the magnitudes of a[0 .. n)
+ * and b[0 .. n).
+ *
+ */
+
+int operand_limbs(const std::uint32_t* a, const std::uint32_t* b, int n) {
+    return std::max(operand_limbs(a, n), operand_limbs(b, n));
+}
+
+/*
+ * Records the time from its construction to its destruction with
+ * HugeIntMetrics, unless it is nested in another OperationTimer on the same
+ * thread: an operation is counted once, and not again for the operations
+ * (negation, addition, multiplication, ...) that it is built from.
+ *
+ */
+
+class OperationTimer {
+public:
+    OperationTimer(iota::HugeIntMetrics::Operation operation, int limbs)
+        : operation_{operation}, limbs_{limbs}, outermost_{depth++ == 0},
+          start_{outermost_ ? Clock::now() : Clock::time_point{}} {}
+
+    ~OperationTimer() {
+        --depth;
+        if (outermost_) {
+            const auto elapsed = Clock::now() - start_;
+            iota::HugeIntMetrics::record(operation_, limbs_,
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                    .count());
+        }
+    }
+
+    OperationTimer(const OperationTimer&) = delete;
+    OperationTimer& operator=(const OperationTimer&) = delete;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static thread_local int depth;    // no. timers alive on this thread
+
+    iota::HugeIntMetrics::Operation operation_;
+    int                             limbs_;
+    bool                            outermost_;
+    Clock::time_point               start_;
+};
+
+thread_local int OperationTimer::depth{0};
+#endif
+
 } /* anonymous namespace */
 
 
@@ -92,7 +629,8 @@ HugeInt::HugeInt(long long int x) {
  *
  * Construct a HugeInt from a null-terminated C string representing the
  * base 10 representation of the number. The string is assumed to have 
- * the form "[+/-]31415926", including an optional '+' or '-' sign. 
+ * the form "[+/-]31415926", including an optional '+' or '-' sign. The 
+ * digits are converted by parseDecimalDigits.
  *
  * WARNING: No spaces are allowed in the decimal string containing numerals.
  * 
@@ -103,6 +641,9 @@ HugeInt::HugeInt(long long int x) {
 HugeInt::HugeInt(const char *const str) {
     const std::size_t len{std::strlen(str)};
 
+    // 9.63 decimal digits per limb
+    HUGEINT_MEASURE(parse, static_cast<int>(len * 100 / 963 + 1));
+
     if (len == 0) {
         throw std::invalid_argument{"empty decimal string in constructor."};
     }
@@ -129,19 +670,7 @@ HugeInt::HugeInt(const char *const str) {
         throw std::invalid_argument{"string contains non-digit in constructor."};
     }
 
-    // Loop (backwards) through each decimal digit, digit[i], in the string, 
-    // adding its numerical contribution, digit[i]*10^i, to theNumber. Here i 
-    // runs upwards from zero, starting at the right-most digit of the string 
-    // of decimal digits.
-    HugeInt theNumber;       // zero by default
-    HugeInt powerOfTen{1LL}; // initially 10^0 = 1
-    
-    for (size_t i = 0; i < numDecimalDigits; ++i) {
-        std::uint32_t digitValue = 
-            static_cast<std::uint32_t>(str[len - 1 - i]) - '0';
-        theNumber += powerOfTen.shortMultiply(digitValue);
-        powerOfTen = powerOfTen.shortMultiply(10);
-    }
+    HugeInt theNumber{parseDecimalDigits(str + offset, numDecimalDigits, 0)};
 
     if (flagNegative) {
         theNumber.radixComplement();
@@ -395,6 +924,72 @@ std::string HugeInt::toDecimalString() const {
     return oss.str();
 }
 
+/**
+ * toDigitString()
+ * 
+ * Format a HugeInt as a plain string of decimal digits, with a leading '-' 
+ * if negative and no separators, e.g., "-31415926".
+ * 
+ * The conversion divides by a tree of powers 10^(9*2^k): a value below 
+ * 10^(9*2^(k+1)) is split by 10^(9*2^k) into a high and a low half of 
+ * equal numbers of digits, which are converted independently, down to 
+ * single 9-digit chunks. Each level costs one long division per node, with 
+ * operands of half the size of the level above. Every node knows how many 
+ * digits it produces, so the digits are written straight into a single 
+ * preallocated buffer at their final offsets, and the two halves of a node 
+ * may be converted concurrently (see writeDecimalDigits).
+ * 
+ * @return 
+ */
+
+std::string HugeInt::toDigitString() const {
+    HUGEINT_MEASURE(print, operand_limbs(digits_, numDigits_));
+
+    if (isZero()) {
+        return "0";
+    }
+
+    HugeInt magnitude{*this};
+    std::string sign;
+    
+    if (isNegative()) {
+        magnitude.radixComplement();
+        sign = "-";
+    }
+    
+    // Long division needs a spare high digit in the dividend, so peel off
+    // low chunks by short division until the top digit is clear.
+    std::string lowChunks;
+    
+    while (magnitude.digits_[numDigits_ - 1] != 0) {
+        std::string chunk(9, '0');
+        
+        writeDecimalChunk(divide_digits(magnitude.digits_, numDigits_, billion,
+                                        magnitude.digits_), &chunk[0]);
+        lowChunks.insert(0, chunk);
+    }
+    
+    const std::vector<HugeInt>& powers{decimalPowers()};
+    
+    const int last{static_cast<int>(powers.size()) - 1};
+    int       k{0};
+    
+    while (k < last && magnitude >= powers[k + 1]) {
+        ++k;
+    }
+    if (magnitude < powers[0]) {
+        k = -1;
+    }
+    
+    std::string digits(k < 0 ? 9 : 9 * (std::size_t{2} << k), '0');
+    magnitude.writeDecimalDigits(k, &digits[0], 0);
+    digits += lowChunks;
+    
+    const std::size_t firstNonZero{digits.find_first_not_of('0')};
+    
+    return sign + digits.substr(firstNonZero);
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // Useful informational member functions                                   //
 /////////////////////////////////////////////////////////////////////////////
@@ -435,6 +1030,58 @@ HugeInt HugeInt::getMaximum() {
     return retval;
 }
 
+/**
+ * setParallelDepth()
+ * 
+ * Set the number of levels of Karatsuba recursion in operator* whose 
+ * sub-products are formed concurrently: up to 3^depth products of operands 
+ * with at least parallelCutoff digits are run at once. The same depth 
+ * applies to the splitting of large values in decimal conversion (see 
+ * toDigitString and parseDecimalDigits). Zero (the default) multiplies and 
+ * converts on the calling thread only. Static member function.
+ * 
+ * @param depth
+ */
+
+void HugeInt::setParallelDepth(int depth) {
+    parallelDepth = std::max(0, depth);
+}
+
+/**
+ * getParallelDepth()
+ * 
+ * @return 
+ */
+
+int HugeInt::getParallelDepth() {
+    return parallelDepth;
+}
+
+/**
+ * setKaratsubaCutoff()
+ * 
+ * Set the number of digits (of both operands) from which operator* uses 
+ * Karatsuba's method, at least 4. The default is tuning::karatsubaCutoff 
+ * (see HugeIntTuning.h); the tuning program sets it to find the crossover 
+ * with schoolbook multiplication. Static member function.
+ * 
+ * @param cutoff
+ */
+
+void HugeInt::setKaratsubaCutoff(int cutoff) {
+    karatsubaCutoff = std::max(4, cutoff);
+}
+
+/**
+ * getKaratsubaCutoff()
+ * 
+ * @return 
+ */
+
+int HugeInt::getKaratsubaCutoff() {
+    return karatsubaCutoff;
+}
+
 /**
  * numDecimalDigits()
  * 
@@ -464,6 +1111,135 @@ int HugeInt::numDecimalDigits() const {
     }
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// Bit-level utilities                                                     //
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * bitLength()
+ * 
+ * Return the number of significant bits in this HugeInt, i.e., the smallest 
+ * b such that x < 2^b. Zero has bit length 0.
+ * 
+ * WARNING: assumes the HugeInt is NON-NEGATIVE.
+ * 
+ * @return 
+ */
+
+int HugeInt::bitLength() const {
+    int i{numDigits_};
+    for ( ; i > 0 && digits_[i - 1] == 0; --i);
+    
+    if (i == 0) {
+        return 0;
+    }
+    
+    int bits{32 * (i - 1)};
+    for (std::uint32_t top = digits_[i - 1]; top != 0; top >>= 1) {
+        ++bits;
+    }
+    
+    return bits;
+}
+
+/**
+ * shortModulo:
+ * 
+ * Return the remainder of a base 2^32 short division by divisor, where 
+ * 0 < divisor <= 2^32 - 1. Cheaper than shortDivide when the quotient is 
+ * not needed, since only the significant digits are visited. A power of 
+ * two is a mask of the lowest digit; otherwise each digit costs a division 
+ * by precomputed reciprocal (see LimbDivisor).
+ * 
+ * WARNING: assumes both HugeInt and the divisor are POSITIVE.
+ * 
+ * @param divisor
+ * @return 
+ */
+
+std::uint32_t HugeInt::shortModulo(std::uint32_t divisor) const {
+    if ((divisor & (divisor - 1)) == 0) {
+        return digits_[0] & (divisor - 1);
+    }
+
+    int n{numDigits_};
+    for ( ; n > 0 && digits_[n - 1] == 0; --n);
+    
+    return divide_digits(digits_, n, LimbDivisor{divisor}, nullptr);
+}
+
+/**
+ * shiftLeftBits
+ * 
+ * Shift this HugeInt left by num bits (multiply by 2^num), filling with 
+ * zeroes from the right. Bits shifted beyond the most significant digit 
+ * are lost.
+ * 
+ * @param num
+ * @return 
+ */
+
+HugeInt& HugeInt::shiftLeftBits(int num) {
+    const int wholeDigits{num / 32};
+    const int bits{num % 32};
+    
+    if (wholeDigits >= static_cast<int>(numDigits_)) {
+        *this = 0LL;
+        return *this;
+    }
+    
+    shiftLeftDigits(wholeDigits);
+    
+    if (bits != 0) {
+        for (int i = numDigits_ - 1; i > 0; --i) {
+            digits_[i] = (digits_[i] << bits) | (digits_[i - 1] >> (32 - bits));
+        }
+        digits_[0] <<= bits;
+    }
+    
+    return *this;
+}
+
+/**
+ * shiftRightBits
+ * 
+ * Shift this HugeInt right by num bits (divide by 2^num, discarding the 
+ * remainder), filling with zeroes from the left.
+ * 
+ * WARNING: assumes the HugeInt is NON-NEGATIVE.
+ * 
+ * @param num
+ * @return 
+ */
+
+HugeInt& HugeInt::shiftRightBits(int num) {
+    const int wholeDigits{num / 32};
+    const int bits{num % 32};
+    
+    if (wholeDigits >= static_cast<int>(numDigits_)) {
+        *this = 0LL;
+        return *this;
+    }
+    
+    if (wholeDigits != 0) {
+        for (int i = 0; i < static_cast<int>(numDigits_) - wholeDigits; ++i) {
+            digits_[i] = digits_[i + wholeDigits];
+        }
+        for (int i = numDigits_ - wholeDigits; i < static_cast<int>(numDigits_); ++i) {
+            digits_[i] = 0;
+        }
+    }
+    
+    if (bits != 0) {
+        for (std::size_t i = 0; i < numDigits_ - 1; ++i) {
+            digits_[i] = (digits_[i] >> bits) | (digits_[i + 1] << (32 - bits));
+        }
+        digits_[numDigits_ - 1] >>= bits;
+    }
+    
+    return *this;
+}
+
 ////////////////////////////////////////////////////////////////////////////
 // friend functions                                                       //
 ////////////////////////////////////////////////////////////////////////////
@@ -486,6 +1262,9 @@ int HugeInt::numDecimalDigits() const {
  */
 
 HugeInt operator+(const HugeInt& a, const HugeInt& b) {
+    HUGEINT_MEASURE(add,
+                    operand_limbs(a.digits_, b.digits_, HugeInt::numDigits_));
+
     HugeInt sum;
     
     std::uint64_t partial{0};
@@ -518,6 +1297,9 @@ HugeInt operator+(const HugeInt& a, const HugeInt& b) {
  */
 
 HugeInt operator-(const HugeInt& a, const HugeInt& b) {
+    HUGEINT_MEASURE(subtract,
+                    operand_limbs(a.digits_, b.digits_, HugeInt::numDigits_));
+
     return a + (-b);
 }
 
@@ -525,7 +1307,16 @@ HugeInt operator-(const HugeInt& a, const HugeInt& b) {
  * friend binary operator *
  *
  * Multiply two HugeInt numbers. Uses standard long multipication algorithm
- * adapted to base 2^32. See comments on implicit conversion before 
+ * adapted to base 2^32, accumulating each row a_i * b directly into the 
+ * product. Leading zero digits of a and b are skipped, and digits of the 
+ * product beyond the most significant are never formed, so the cost is 
+ * proportional to the product of the operand sizes rather than to N^2. 
+ * Negative operands are replaced by their magnitudes, so that they too have 
+ * leading zeros. When both operands have at least getKaratsubaCutoff() 
+ * digits, Karatsuba's method is used instead (see karatsuba_multiply), with 
+ * its sub-products run concurrently down to getParallelDepth() levels. 
+ * Equal operands are squared, with about half the digit products. See 
+ * comments on implicit conversion before 
  * HugeInt operator+(const HugeInt&, const HugeInt&) above, which are 
  * applicable here also.
  * 
@@ -535,12 +1326,70 @@ HugeInt operator-(const HugeInt& a, const HugeInt& b) {
  */
 
 HugeInt operator*(const HugeInt& a, const HugeInt& b) {
+    HUGEINT_MEASURE(multiply,
+                    operand_limbs(a.digits_, b.digits_, HugeInt::numDigits_));
+
+    // Multiply magnitudes, which (unlike radix complements) have leading 
+    // zeros. The test excludes getMinimum(), which is its own negative.
+    if (a.isNegative() || b.isNegative()) {
+        const HugeInt u{a.isNegative() ? -a : a};
+        const HugeInt v{b.isNegative() ? -b : b};
+        
+        if (!u.isNegative() && !v.isNegative()) {
+            const HugeInt product{u * v};
+            
+            return a.isNegative() != b.isNegative() ? -product : product;
+        }
+    }
+    
+    const int N{HugeInt::numDigits_};
+    
+    int na{N};
+    for ( ; na > 0 && a.digits_[na - 1] == 0; --na);
+    
+    int nb{N};
+    for ( ; nb > 0 && b.digits_[nb - 1] == 0; --nb);
+    
     HugeInt product;
-    HugeInt partial;
+    
+    // squares, recognised by value, go to the squaring kernels
+    const bool square{na == nb && 
+                      std::equal(a.digits_, a.digits_ + na, b.digits_)};
+    
+    const int cutoff{karatsubaCutoff};
+    
+    if (square || std::min(na, nb) >= cutoff) {
+        std::vector<std::uint32_t> full(na + nb);
+        
+        multiply_digits(a.digits_, na, square ? a.digits_ : b.digits_, nb, 
+                        full.data(), cutoff);
+        std::copy(full.begin(), full.begin() + std::min(N, na + nb), 
+                  product.digits_);
+        
+        return product;
+    }
 
-    for (std::size_t i = 0; i < HugeInt::numDigits_; ++i) {
-        partial = a.shortMultiply(b.digits_[i]);
-        product += partial.shiftLeftDigits(i);
+    for (int i = 0; i < na; ++i) {
+        const std::uint64_t ai{a.digits_[i]};
+        
+        if (ai == 0) {
+            continue;
+        }
+        
+        std::uint64_t partial{0};
+        const int     jmax{nb < N - i ? nb : N - i};
+        
+        for (int j = 0; j < jmax; ++j) {
+            partial += product.digits_[i + j] + ai * b.digits_[j];
+            product.digits_[i + j] = static_cast<std::uint32_t>(partial);
+            partial >>= 32;
+        }
+        
+        for (int k = i + jmax; k < N && partial != 0; ++k) {
+            partial += product.digits_[k];
+            product.digits_[k] = static_cast<std::uint32_t>(partial);
+            partial >>= 32;
+        }
     }
 
     return product;
@@ -560,6 +1409,9 @@ HugeInt operator*(const HugeInt& a, const HugeInt& b) {
  * @return 
  */
 HugeInt operator/(const HugeInt& a, const HugeInt& b) {    
+    HUGEINT_MEASURE(divide,
+                    operand_limbs(a.digits_, b.digits_, HugeInt::numDigits_));
+
     if (a < 0) {
         if (b < 0) {
             return unsigned_divide(-a, -b, nullptr);
@@ -593,6 +1445,9 @@ HugeInt operator/(const HugeInt& a, const HugeInt& b) {
  */
 
 HugeInt operator%(const HugeInt& a, const HugeInt& b) {
+    HUGEINT_MEASURE(modulo,
+                    operand_limbs(a.digits_, b.digits_, HugeInt::numDigits_));
+
     HugeInt remainder;
        
     if (a < 0) {
@@ -617,6 +1472,113 @@ HugeInt operator%(const HugeInt& a, const HugeInt& b) {
     }
 }
 
+/**
+ * friend function divexact
+ *
+ * Return the quotient a / b of two HugeInt numbers, for a divisor b known to
+ * divide a exactly, by Jebelean's exact division: the quotient is found
+ * from its least significant digit upwards, each digit q_k being the
+ * dividend's current digit k times the inverse of the divisor's lowest digit
+ * mod 2^32, after which q_k * b is subtracted from the dividend. Only the
+ * digits of the dividend below the length of the quotient are ever needed,
+ * so the products are truncated there, which halves the work of Algorithm D
+ * for a quotient as long as the divisor. There are no trial quotient digits
+ * to correct and no normalisation.
+ *
+ * Common low zero bits are first shifted out, so that the divisor is odd
+ * (and invertible mod 2^32). If b does not divide a, the result is
+ * meaningless. Compiled with HUGEINT_CHECK_DIVEXACT defined (for debugging
+ * callers; off by default, since it costs a full multiplication), the
+ * quotient is checked by multiplying it back, and std::domain_error is
+ * thrown if b does not divide a. Division by zero throws std::domain_error
+ * in any case.
+ *
+ * @param a
+ * @param b
+ * @return
+ */
+
+HugeInt divexact(const HugeInt& a, const HugeInt& b) {
+    HUGEINT_MEASURE(exactDivide,
+                    operand_limbs(a.digits_, b.digits_, HugeInt::numDigits_));
+
+    if (b.isZero()) {
+        throw std::domain_error{"HugeInt division by zero."};
+    }
+
+    const bool negative{a.isNegative() != b.isNegative()};
+    HugeInt    dividend{a.isNegative() ? -a : a};
+    HugeInt    divisor{b.isNegative() ? -b : b};
+
+    int shifts{0};
+    for ( ; divisor.digits_[shifts / 32] == 0; shifts += 32);
+    for ( ; ((divisor.digits_[shifts / 32] >> (shifts % 32)) & 1) == 0;
+          ++shifts);
+    if (shifts != 0) {
+        dividend.shiftRightBits(shifts);
+        divisor.shiftRightBits(shifts);
+    }
+
+    int n{HugeInt::numDigits_};
+    for ( ; n > 0 && divisor.digits_[n - 1] == 0; --n);
+
+    int m{HugeInt::numDigits_};
+    for ( ; m > 0 && dividend.digits_[m - 1] == 0; --m);
+
+    HugeInt quotient;
+
+    if (m >= n) {
+        // inverse of the odd lowest digit mod 2^32 by Newton's iteration,
+        // which doubles the number of correct low bits (3 to begin with)
+        const std::uint32_t d0{divisor.digits_[0]};
+        std::uint32_t       inverse{d0};
+        for (int i = 0; i < 4; ++i) {
+            inverse *= 2 - d0 * inverse;
+        }
+
+        const int length{m - n + 1};    // quotient digits
+        for (int k = 0; k < length; ++k) {
+            const std::uint32_t q{dividend.digits_[k] * inverse};
+            const int           top{std::min(n, length - k)};
+
+            quotient.digits_[k] = q;
+
+            // dividend -= q * divisor * (2^32)^k, up to digit length - 1
+            std::uint64_t carry{0};
+            std::uint64_t borrow{0};
+            for (int i = 0; i < top; ++i) {
+                const std::uint64_t product{static_cast<std::uint64_t>(q)
+                                            * divisor.digits_[i] + carry};
+                const std::uint64_t digit{dividend.digits_[k + i]
+                                          - (product & 0xffffffffULL)
+                                          - borrow};
+                dividend.digits_[k + i] = static_cast<std::uint32_t>(digit);
+                carry = product >> 32;
+                borrow = digit >> 63;
+            }
+
+            std::uint64_t pending{carry + borrow};
+            for (int j = k + top; j < length && pending != 0; ++j) {
+                const std::uint64_t digit{dividend.digits_[j] - pending};
+                dividend.digits_[j] = static_cast<std::uint32_t>(digit);
+                pending = digit >> 63;
+            }
+        }
+    }
+
+    if (negative) {
+        quotient.radixComplement();
+    }
+
+#ifdef HUGEINT_CHECK_DIVEXACT
+    if (quotient * b != a) {
+        throw std::domain_error{"divexact: divisor does not divide dividend."};
+    }
+#endif
+
+    return quotient;
+}
+
 /**
  * unsigned_divide: (private utility function)
  * 
@@ -679,17 +1641,11 @@ HugeInt unsigned_divide(const HugeInt& a, const HugeInt& b,
     }
     
     // CASE 2: Divisor has only one base-2^32 digit (n = 1). Do a short 
-    //         division and return.
+    //         division by precomputed reciprocal and return.
     if (n < 2) {
-        std::uint64_t partial{0};
-        
-        for (int i = m - 1 ; i >= 0; --i) {
-            partial = HugeInt::base_ * partial 
-                    + static_cast<std::uint64_t>(dividend.digits_[i]);
-            quotient.digits_[i] = 
-                    static_cast<std::uint32_t>(partial / divisor.digits_[0]);
-            partial %= divisor.digits_[0];
-        } 
+        const std::uint32_t partial{divide_digits(dividend.digits_, m, 
+                                        LimbDivisor{divisor.digits_[0]},
+                                        quotient.digits_)};
         
         if (remainder != nullptr) {
             if (*remainder != 0) {
@@ -724,42 +1680,37 @@ HugeInt unsigned_divide(const HugeInt& a, const HugeInt& b,
     }
     divisor.digits_[0] = divisor.digits_[0] << shifts;
     
-    // Prepend a (m+1)'th zero-value digit to the dividend, then shift.
-    dividend.digits_[m] = 
-        static_cast<std::uint64_t>(dividend.digits_[m - 1]) >> (32 - shifts);
+    // Prepend a (m+1)'th zero-value digit to the dividend, then shift. The
+    // scaled dividend is formed in u, which has room for that digit even 
+    // when the dividend has all numDigits_ digits.
+    std::uint32_t u[HugeInt::numDigits_ + 1];
+    
+    u[m] = static_cast<std::uint64_t>(dividend.digits_[m - 1]) >> (32 - shifts);
     for (int i = m - 1; i > 0; --i) {
-        dividend.digits_[i] = (dividend.digits_[i] << shifts) |
+        u[i] = (dividend.digits_[i] << shifts) |
          (static_cast<std::uint64_t>(dividend.digits_[i - 1]) >> (32 - shifts));
     }
-    dividend.digits_[0] = dividend.digits_[0] << shifts;
+    u[0] = dividend.digits_[0] << shifts;
     
     // Do the long division using the primary school algorithm, estimating
-    // partial quotients with a two most significant digit approximation for 
-    // the dividend and a single most significant digit approximation for the 
-    // divisor.
-    for (int k = m - n; k >= 0; --k) {
-        std::uint64_t rhat = dividend.digits_[k + n] * HugeInt::base_ 
-            + static_cast<std::uint64_t>(dividend.digits_[k + n - 1]);
-        
-        std::uint64_t qhat = rhat / divisor.digits_[n - 1];
+    // partial quotients by dividing the three most significant digits of the 
+    // dividend by the two most significant digits of the divisor, using 
+    // Moller and Granlund's precomputed reciprocal of the latter in place of 
+    // hardware division (see divide_3by2).
+    const std::uint32_t d1{divisor.digits_[n - 1]};
+    const std::uint32_t d0{divisor.digits_[n - 2]};
+    const std::uint32_t reciprocal{reciprocal_3by2(d1, d0)};
     
-        rhat %= divisor.digits_[n - 1];
+    for (int k = m - n; k >= 0; --k) {
+        const std::uint32_t u2{u[k + n]};
+        const std::uint32_t u1{u[k + n - 1]};
         
-        // Digit q_k estimated by qhat must satisfy 0 <= q_k <= base_ - 1. 
-        // If too large, decrement and adjust remainder rhat accordingly.
-        if (qhat == HugeInt::base_) {
-            qhat -= 1;
-            rhat += divisor.digits_[n - 1];
-        }
-       
-        // Compare with a "second order" approximation to the partial quotient. 
-        // If this comparison indicates that qhat overestimates, decrement,
-        // adjust remainder rhat and repeat.
-        while (rhat < HugeInt::base_ && (qhat * divisor.digits_[n - 2]
-                > HugeInt::base_ * rhat + dividend.digits_[k + n - 2])) {
-            qhat -= 1;
-            rhat += divisor.digits_[n - 1];
-        }
+        // The top two digits never exceed those of the divisor; if equal, 
+        // the quotient digit is base_ - 1 or base_ - 2, the former being 
+        // corrected below if necessary.
+        const std::uint64_t qhat{u2 == d1 && u1 == d0 
+            ? HugeInt::base_ - 1 
+            : divide_3by2(u2, u1, u[k + n - 2], d1, d0, reciprocal)};
         
         // We have an estimate qhat for the true digit q_k that satisfies
         // q_k <= qhat <= q_k + 1. Calculate the corresponding remainder 
@@ -774,18 +1725,17 @@ HugeInt unsigned_divide(const HugeInt& a, const HugeInt& b,
             std::uint64_t product = static_cast<std::uint32_t>(qhat) 
                             * static_cast<std::uint64_t>(divisor.digits_[i]);
             
-            widedigit = (dividend.digits_[k + i] + carry) 
-                        - (product & 0xffffffffLL);
+            widedigit = (u[k + i] + carry) - (product & 0xffffffffLL);
             
-            dividend.digits_[k + i] = widedigit; // assigns 2^32-complement
-                                                 // if widedigit < 0
+            u[k + i] = widedigit;   // assigns 2^32-complement
+                                    // if widedigit < 0
             
             carry = (widedigit >> 32) - (product >> 32);
         }
         
-        widedigit = dividend.digits_[k + n] + carry;
-        dividend.digits_[k + n] = widedigit;           // 2^32-complement if
-                                                       // widedigit < 0
+        widedigit = u[k + n] + carry;
+        u[k + n] = widedigit;       // 2^32-complement if
+                                    // widedigit < 0
         
         // Accept and store the tentative quotient digit.
         quotient.digits_[k] = qhat;
@@ -800,13 +1750,13 @@ HugeInt unsigned_divide(const HugeInt& a, const HugeInt& b,
             quotient.digits_[k] -= 1;
             widedigit = 0;
             for (int i = 0; i < n; ++i) {
-                widedigit += static_cast<std::uint64_t>(dividend.digits_[k + i])
+                widedigit += static_cast<std::uint64_t>(u[k + i])
                            + divisor.digits_[i];
-                dividend.digits_[k + i] = widedigit;
+                u[k + i] = widedigit;
                 widedigit >>= 32;
             }
             
-            dividend.digits_[k + n] += carry;
+            u[k + n] += carry;
         }
     } /* end main loop over k */
     
@@ -816,15 +1766,14 @@ HugeInt unsigned_divide(const HugeInt& a, const HugeInt& b,
             *remainder == 0LL;
         }
     
-        // Denormalise dividend, which now contains the full remainder 
+        // Denormalise u, which now contains the full remainder 
         // (stored in n - 1 digits). 
         for (int i = 0; i < n - 1; ++i) {
-            remainder->digits_[i] = (dividend.digits_[i] >> shifts) |
-                    (static_cast<std::uint64_t>(dividend.digits_[i + 1]) 
-                        << (32 - shifts));
+            remainder->digits_[i] = (u[i] >> shifts) |
+                    (static_cast<std::uint64_t>(u[i + 1]) << (32 - shifts));
         }
     
-        remainder->digits_[n - 1] = dividend.digits_[n - 1] >> shifts;
+        remainder->digits_[n - 1] = u[n - 1] >> shifts;
     }
     
     return quotient; 
@@ -844,10 +1793,27 @@ bool operator!=(const HugeInt& lhs, const HugeInt& rhs) {
    return !(rhs == lhs);
 }
 
+/*
+ * Operands of opposite signs are ordered by their signs; operands of the
+ * same sign are ordered as their radix complements are, as unsigned values.
+ * (The sign of lhs - rhs would be wrong when the difference overflows,
+ * e.g., for operands near getMinimum() and getMaximum().)
+ */
+
 bool operator<(const HugeInt& lhs, const HugeInt& rhs) {
-   HugeInt diff{lhs - rhs};
-   
-   return diff.isNegative();
+    const bool negative{lhs.isNegative()};
+
+    if (negative != rhs.isNegative()) {
+        return negative;
+    }
+
+    for (int i = HugeInt::numDigits_ - 1; i >= 0; --i) {
+        if (lhs.digits_[i] != rhs.digits_[i]) {
+            return lhs.digits_[i] < rhs.digits_[i];
+        }
+    }
+
+    return false;
 }
 
 bool operator>(const HugeInt& lhs, const HugeInt& rhs) {
@@ -931,8 +1897,9 @@ HugeInt HugeInt::shortMultiply(std::uint32_t multiplier) const {
  * 
  * Return the result of a base 2^32 short division by divisor, where 
  * 0 < divisor <= 2^32 - 1, using the usual primary school algorithm 
- * adapted to radix 2^32. If not a nullptr, the remainder is returned 
- * in space allocated by the caller. 
+ * adapted to radix 2^32, with each digit divided by precomputed reciprocal 
+ * (see LimbDivisor). If not a nullptr, the remainder is returned in space 
+ * allocated by the caller. 
  *
  * WARNING: assumes both HugeInt and the divisor are POSITIVE.
  * 
@@ -944,15 +1911,14 @@ HugeInt HugeInt::shortDivide(std::uint32_t divisor,
                              std::uint32_t* const remainder) const {
     HugeInt quotient;
     
-    std::uint64_t partial{0};
-    for (int i = numDigits_ - 1; i >= 0; --i) {
-        partial = base_ * partial + static_cast<std::uint64_t>(digits_[i]);
-        quotient.digits_[i] = static_cast<std::uint32_t>(partial / divisor);
-        partial %= divisor;
-    }
+    int n{numDigits_};
+    for ( ; n > 0 && digits_[n - 1] == 0; --n);
+
+    const std::uint32_t partial{divide_digits(digits_, n, LimbDivisor{divisor},
+                                              quotient.digits_)};
 
     if (remainder != nullptr) {
-        *remainder = static_cast<uint32_t>(partial);
+        *remainder = partial;
     }
     
     return quotient;
@@ -985,6 +1951,154 @@ HugeInt& HugeInt::shiftLeftDigits(int num) {
     return *this;
 }
 
+/**
+ * writeDecimalDigits
+ * 
+ * Write exactly 9 * 2^(k+1) decimal digits of this HugeInt, zero-padded on
+ * the left, to digits[0 ..). Requires 0 <= *this < 10^(9*2^(k+1)), or 
+ * k = -1 and 0 <= *this < 10^9. See toDigitString().
+ * 
+ * The high and low halves write to disjoint ranges of digits; above 
+ * parallelConversionCutoff, and down to getParallelDepth() levels of 
+ * recursion, the high half is converted on a separate thread.
+ * 
+ * @param k
+ * @param digits
+ * @param depth
+ */
+
+void HugeInt::writeDecimalDigits(int k, char* digits, int depth) const {
+    if (k < 0) {
+        int n{numDigits_};
+        for ( ; n > 0 && digits_[n - 1] == 0; --n);
+
+        writeDecimalChunk(divide_digits(digits_, n, billion, nullptr), digits);
+        return;
+    }
+    
+    const std::size_t half{9 * (std::size_t{1} << k)};
+    
+    if (isZero()) {
+        std::fill(digits, digits + 2 * half, '0');
+        return;
+    }
+    
+    HugeInt low;
+    const HugeInt high{unsigned_divide(*this, decimalPowers()[k], &low)};
+    
+    if (depth < parallelDepth && k >= parallelConversionCutoff) {
+        auto future = std::async(std::launch::async, [&] {
+            high.writeDecimalDigits(k - 1, digits, depth + 1);
+        });
+        low.writeDecimalDigits(k - 1, digits + half, depth + 1);
+        future.get();
+    }
+    else {
+        high.writeDecimalDigits(k - 1, digits, depth + 1);
+        low.writeDecimalDigits(k - 1, digits + half, depth + 1);
+    }
+}
+
+/**
+ * writeDecimalChunk
+ * 
+ * Write the 9 decimal digits of chunk (0 <= chunk < 10^9), zero-padded on
+ * the left, to digits[0 .. 9).
+ * 
+ * @param chunk
+ * @param digits
+ */
+
+void HugeInt::writeDecimalChunk(std::uint32_t chunk, char* digits) {
+    for (int i = 8; i >= 0; --i) {
+        digits[i] = static_cast<char>('0' + chunk % 10);
+        chunk /= 10;
+    }
+}
+
+/**
+ * parseDecimalDigits
+ * 
+ * Return the value of the n decimal digits str[0 .. n), n > 0 (reduced 
+ * modulo (2^32)^N if it is not representable). The inverse of the 
+ * conversion in toDigitString: with 9 * 2^k the largest tabulated chunk 
+ * length below n, the last 9 * 2^k digits form the low part L and the rest 
+ * the high part H of the value H * 10^(9*2^k) + L, and both are parsed 
+ * recursively, down to 9-digit chunks. The parts are independent and, 
+ * above parallelConversionCutoff and down to getParallelDepth() levels of 
+ * recursion, H is parsed on a separate thread. Static member function.
+ * 
+ * @param str
+ * @param n
+ * @param depth
+ * @return
+ */
+
+HugeInt HugeInt::parseDecimalDigits(const char* str, std::size_t n, 
+                                    int depth) {
+    if (n <= 9) {
+        long long int chunk{0};
+        
+        for (std::size_t i = 0; i < n; ++i) {
+            chunk = 10 * chunk + (str[i] - '0');
+        }
+        
+        return HugeInt{chunk};
+    }
+    
+    const std::vector<HugeInt>& powers{decimalPowers()};
+    
+    int k{0};
+    while (k + 1 < static_cast<int>(powers.size()) && 
+           9 * (std::size_t{2} << k) < n) {
+        ++k;
+    }
+    
+    const std::size_t lowLength{9 * (std::size_t{1} << k)};
+    const std::size_t highLength{n - lowLength};
+    HugeInt           high;
+    HugeInt           low;
+    
+    if (depth < parallelDepth && k >= parallelConversionCutoff) {
+        auto future = std::async(std::launch::async, [&] {
+            return parseDecimalDigits(str, highLength, depth + 1);
+        });
+        low = parseDecimalDigits(str + highLength, lowLength, depth + 1);
+        high = future.get();
+    }
+    else {
+        high = parseDecimalDigits(str, highLength, depth + 1);
+        low = parseDecimalDigits(str + highLength, lowLength, depth + 1);
+    }
+    
+    return high * powers[k] + low;
+}
+
+/**
+ * decimalPowers
+ * 
+ * Return the table of powers 10^(9*2^k), k = 0, 1, 2, ..., used for decimal 
+ * conversion: all of those whose square is representable as a HugeInt. 
+ * Built once, on first use.
+ * 
+ * @return 
+ */
+
+const std::vector<HugeInt>& HugeInt::decimalPowers() {
+    static const std::vector<HugeInt> powers = [] {
+        const int            bits{32 * static_cast<int>(numDigits_)};
+        std::vector<HugeInt> table{HugeInt{1000000000LL}};
+        
+        while (2 * table.back().bitLength() < bits) {
+            table.push_back(table.back() * table.back());
+        }
+        
+        return table;
+    }();
+    
+    return powers;
+}
+
 /**
  * radixComplement()
  *
@@ -1026,44 +2140,24 @@ HugeInt& HugeInt::radixComplement() {
  */
 
 std::ostream& operator<<(std::ostream& output, const HugeInt& x) {
-    // Special case HugeInt == 0 is easy
-    if (x == 0) {
-        output << "0";
-        return output;
-    }
-
-    // Set copy to the absolute value of *this
-    // for use in shortDivide.
-    HugeInt copy;
+    const std::string digits{x.toDigitString()};
+    std::size_t       i{0};
     
-    if (x < 0) {
-        output << "-";
-        copy = -x;
-    } 
-    else {
-        copy = x;
+    if (digits[0] == '-') {
+        output << '-';
+        i = 1;
     }
-
-    // Determine the triples.
-    int i{0};
-    const int numTriples{static_cast<int>(HugeInt::numDigits_ * 3.211) + 2};
-    std::uint32_t triples[numTriples]{0};
     
-    while (copy != 0) {
-        std::uint32_t remainder;
-        copy = copy.shortDivide(1000, &remainder);
-        triples[i++] = remainder;
-    }
-
     // first set of thousands has no preceding zeros
-    --i;
-    output << triples[i];
+    std::size_t lead{(digits.size() - i) % 3};
+    if (lead == 0) {
+        lead = 3;
+    }
+    output << digits.substr(i, lead);
     
     // all the other sets of thousands
-    output << std::setfill('0');
-    
-    for (int j = i - 1; j >= 0; --j) {
-        output << ',' << std::setw(3) << triples[j];
+    for (i += lead; i < digits.size(); i += 3) {
+        output << ',' << digits.substr(i, 3);
     }
     
     return output;
@@ -50,6 +50,7 @@
 
 #include <string>
 #include <iosfwd>
+#include <vector>
 
 namespace iota {
 
@@ -76,6 +77,8 @@ public:
     friend HugeInt operator/(const HugeInt&, const HugeInt&);
     friend HugeInt operator%(const HugeInt&, const HugeInt&);
 
+    // exact division, for a divisor known to divide the dividend
+    friend HugeInt divexact(const HugeInt&, const HugeInt&);
 
     // increment and decrement operators
     HugeInt& operator+=(const HugeInt&);
@@ -99,28 +102,50 @@ public:
     // input/output 
     std::string toRawString() const;
     std::string toDecimalString() const;
+    std::string toDigitString() const;
     friend std::ostream& operator<<(std::ostream&, const HugeInt&);
     friend std::istream& operator>>(std::istream&, HugeInt&);
     
     // informational
     int numDecimalDigits() const;
+    bool isZero() const;
+    bool isNegative() const;
     static HugeInt getMinimum();
     static HugeInt getMaximum();
 
+    // concurrency of large multiplications and decimal conversions
+    static void setParallelDepth(int);
+    static int  getParallelDepth();
+
+    // algorithm thresholds (defaults in HugeIntTuning.h)
+    static void setKaratsubaCutoff(int);
+    static int  getKaratsubaCutoff();
+
+    // bit-level utilities (WARNING: assume a non-negative HugeInt)
+    int           bitLength() const;
+    std::uint32_t shortModulo(std::uint32_t) const;
+    HugeInt&      shiftLeftBits(int);
+    HugeInt&      shiftRightBits(int);
+
 private:
     static const std::size_t   numDigits_{300};   // max. no. base 2^32 digits
     static const std::uint64_t base_{1ULL << 32}; // 2^32, for convenience
     std::uint32_t              digits_[numDigits_]{0}; // base 2^32 digits
 
     // private utility functions
-    bool          isZero() const;
-    bool          isNegative() const;
     HugeInt&      radixComplement();  
     HugeInt       shortMultiply(std::uint32_t) const;
     HugeInt       shortDivide(std::uint32_t, std::uint32_t* const) const;
     friend HugeInt unsigned_divide(const HugeInt&, const HugeInt&, 
                                    HugeInt* const);
+    friend int     jacobi(const HugeInt&, const HugeInt&);
+    friend class   Montgomery;
+    friend class   HugeIntAccumulator;
     HugeInt&      shiftLeftDigits(int);
+    void          writeDecimalDigits(int, char*, int) const;
+    static void   writeDecimalChunk(std::uint32_t, char*);
+    static HugeInt parseDecimalDigits(const char*, std::size_t, int);
+    static const std::vector<HugeInt>& decimalPowers();
 };
 
 } /* namespace iota */
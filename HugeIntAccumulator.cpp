@@ -0,0 +1,365 @@
+/*
+ * HugeIntAccumulator.cpp
+ *
+ * Implementation of the HugeIntAccumulator class. See comments in
+ * HugeIntAccumulator.h for details.
+ *
+ */
+
+#include "HugeIntAccumulator.h"
+#include "HugeIntTuning.h"
+#include <algorithm>
+#include <atomic>
+
+
+/*
+ * Non-member utility functions (in anonymous namespace -- file scope only).
+ *
+ */
+
+namespace { /* anonymous namespace */
+
+using iota::HugeInt;
+
+// no. 32-bit additions a slot below 2^32 can absorb without overflow
+const std::uint64_t maxAdditions{0xFFFFFFFFULL};
+
+// addmul of operands this long (in digits) forms the product by operator*
+std::atomic<int> productCutoff{iota::tuning::productCutoff};
+
+/*
+ * Set magnitude to |x| and return true if x is negative. The magnitude of
+ * HugeInt::getMinimum(), which is its own negative, is taken to be itself,
+ * i.e., its value modulo (2^32)^N.
+ *
+ */
+
+bool split_sign(const HugeInt& x, HugeInt& magnitude) {
+    if (!x.isNegative()) {
+        magnitude = x;
+        return false;
+    }
+
+    magnitude = -x;
+    if (magnitude.isNegative()) {
+        magnitude = x;
+        return false;
+    }
+
+    return true;
+}
+
+/*
+ * Return the number of significant base 2^32 digits in digits[0 .. n).
+ *
+ */
+
+inline int significant_digits(const std::uint32_t* digits, int n) {
+    for ( ; n > 0 && digits[n - 1] == 0; --n);
+
+    return n;
+}
+
+/*
+ * Add digits[0 .. n) to slots[0 .. n), without carrying. Adding every
+ * digit, zero or not, in one branch-free pass (which vectorizes) is faster
+ * than first scanning for the most significant digit.
+ *
+ */
+
+inline void add_digits(const std::uint32_t* digits, int n,
+                       std::uint64_t* slots) {
+    for (int i = 0; i < n; ++i) {
+        slots[i] += digits[i];
+    }
+}
+
+/*
+ * Write the slots, with their carries propagated, to digits[0 .. n); the
+ * final carry is discarded. Requires every slot to be at most 2^64 - 2^32,
+ * so that slot + carry (carry < 2^32) cannot overflow.
+ *
+ */
+
+void propagate(const std::uint64_t* slots, std::uint32_t* digits, int n) {
+    std::uint64_t carry{0};
+
+    for (int i = 0; i < n; ++i) {
+        const std::uint64_t slot{slots[i] + carry};
+
+        digits[i] = static_cast<std::uint32_t>(slot);
+        carry = slot >> 32;
+    }
+}
+
+} /* anonymous namespace */
+
+
+
+namespace iota {
+
+/**
+ * Constructor: an accumulator whose total starts at value.
+ *
+ * @param value
+ */
+
+HugeIntAccumulator::HugeIntAccumulator(const HugeInt& value) {
+    add(value);
+}
+
+/**
+ * add
+ *
+ * Add x to the total.
+ *
+ * @param x
+ * @return
+ */
+
+HugeIntAccumulator& HugeIntAccumulator::add(const HugeInt& x) {
+    accumulate(x, false);
+
+    return *this;
+}
+
+/**
+ * add
+ *
+ * Add the (signed) integer x to the total, touching two slots only.
+ *
+ * @param x
+ * @return
+ */
+
+HugeIntAccumulator& HugeIntAccumulator::add(long long int x) {
+    reserve(1);
+
+    // |x| as unsigned, valid also for the most negative long long
+    const std::uint64_t magnitude{x < 0 ? 0 - static_cast<std::uint64_t>(x)
+                                        : static_cast<std::uint64_t>(x)};
+    std::uint64_t*      slots{x < 0 ? negative_ : positive_};
+
+    slots[0] += magnitude & 0xFFFFFFFFULL;
+    slots[1] += magnitude >> 32;
+    ++additions_;
+
+    return *this;
+}
+
+/**
+ * add
+ *
+ * Add the total of another accumulator to this one. The other total is
+ * normalized (in a copy) first, so that it counts as a single addition.
+ *
+ * @param other
+ * @return
+ */
+
+HugeIntAccumulator& HugeIntAccumulator::add(const HugeIntAccumulator& other) {
+    return add(other.value());
+}
+
+/**
+ * subtract
+ *
+ * Subtract x from the total.
+ *
+ * @param x
+ * @return
+ */
+
+HugeIntAccumulator& HugeIntAccumulator::subtract(const HugeInt& x) {
+    accumulate(x, true);
+
+    return *this;
+}
+
+/**
+ * addmul
+ *
+ * Add the product a * b to the total. Each digit product |a_i| |b_j| is
+ * added, as its low and high halves, to slots i + j and i + j + 1, so that
+ * a slot receives at most 2 min(na, nb) additions, where na and nb are the
+ * numbers of significant digits of |a| and |b|. Digit products beyond the
+ * last slot are not formed (the product is taken modulo (2^32)^N). When
+ * both operands have getProductCutoff() digits or more, the product is
+ * formed by operator* (whose Karatsuba kernels then win) and added as a
+ * whole.
+ *
+ * @param a
+ * @param b
+ * @return
+ */
+
+HugeIntAccumulator& HugeIntAccumulator::addmul(const HugeInt& a,
+                                               const HugeInt& b) {
+    const int N{static_cast<int>(HugeInt::numDigits_)};
+    HugeInt   u;
+    HugeInt   v;
+    const bool negative{split_sign(a, u) != split_sign(b, v)};
+
+    int na{significant_digits(u.digits_, N)};
+    int nb{significant_digits(v.digits_, N)};
+
+    if (na < nb) {
+        std::swap(u, v);
+        std::swap(na, nb);
+    }
+
+    if (nb >= productCutoff) {
+        accumulate(u * v, negative);
+        return *this;
+    }
+
+    reserve(2 * static_cast<std::uint64_t>(nb));
+
+    std::uint64_t* slots{negative ? negative_ : positive_};
+
+    for (int j = 0; j < nb; ++j) {
+        const std::uint64_t vj{v.digits_[j]};
+        const int           imax{std::min(na, N - j)};
+
+        for (int i = 0; i < imax; ++i) {
+            const std::uint64_t product{u.digits_[i] * vj};
+
+            slots[i + j] += product & 0xFFFFFFFFULL;
+            if (i + j + 1 < N) {
+                slots[i + j + 1] += product >> 32;
+            }
+        }
+    }
+    additions_ += 2 * static_cast<std::uint64_t>(nb);
+
+    return *this;
+}
+
+HugeIntAccumulator& HugeIntAccumulator::operator+=(const HugeInt& x) {
+    return add(x);
+}
+
+HugeIntAccumulator& HugeIntAccumulator::operator+=(
+                                        const HugeIntAccumulator& other) {
+    return add(other);
+}
+
+HugeIntAccumulator& HugeIntAccumulator::operator-=(const HugeInt& x) {
+    return subtract(x);
+}
+
+/**
+ * value()
+ *
+ * Return the total, with the pending carries propagated (the accumulator
+ * itself is unchanged).
+ *
+ * @return
+ */
+
+HugeInt HugeIntAccumulator::value() const {
+    const int N{static_cast<int>(HugeInt::numDigits_)};
+    HugeInt   plus;
+    HugeInt   minus;
+
+    propagate(positive_, plus.digits_, N);
+    propagate(negative_, minus.digits_, N);
+
+    return plus - minus;
+}
+
+/**
+ * clear()
+ *
+ * Reset the total to zero.
+ *
+ */
+
+void HugeIntAccumulator::clear() {
+    std::fill(positive_, positive_ + HugeInt::numDigits_, 0);
+    std::fill(negative_, negative_ + HugeInt::numDigits_, 0);
+    additions_ = 0;
+}
+
+/**
+ * setProductCutoff()
+ *
+ * Set the number of digits (of both operands) from which addmul forms the
+ * product by operator*. The default is tuning::productCutoff (see
+ * HugeIntTuning.h). Static member function.
+ *
+ * @param cutoff
+ */
+
+void HugeIntAccumulator::setProductCutoff(int cutoff) {
+    productCutoff = std::max(1, cutoff);
+}
+
+/**
+ * getProductCutoff()
+ *
+ * @return
+ */
+
+int HugeIntAccumulator::getProductCutoff() {
+    return productCutoff;
+}
+
+/**
+ * accumulate: (private utility function)
+ *
+ * Add x to the total, or subtract it if subtract is true, by adding its
+ * digits to the positive or negative slots, without carrying. A negative x
+ * is added as its radix complement, which is congruent to x modulo
+ * (2^32)^N, so no magnitude need be formed.
+ *
+ * @param x
+ * @param subtract
+ */
+
+void HugeIntAccumulator::accumulate(const HugeInt& x, bool subtract) {
+    reserve(1);
+
+    add_digits(x.digits_, static_cast<int>(HugeInt::numDigits_),
+               subtract ? negative_ : positive_);
+    ++additions_;
+}
+
+/**
+ * normalize: (private utility function)
+ *
+ * Propagate the pending carries, leaving every slot below 2^32. Carries out
+ * of the top slots are discarded (arithmetic modulo (2^32)^N).
+ *
+ */
+
+void HugeIntAccumulator::normalize() {
+    for (std::uint64_t* slots : {positive_, negative_}) {
+        std::uint64_t carry{0};
+
+        for (std::size_t i = 0; i < HugeInt::numDigits_; ++i) {
+            const std::uint64_t slot{slots[i] + carry};
+
+            slots[i] = slot & 0xFFFFFFFFULL;
+            carry = slot >> 32;
+        }
+    }
+    additions_ = 0;
+}
+
+/**
+ * reserve: (private utility function)
+ *
+ * Normalize if fewer than count further 32-bit additions can be made to
+ * every slot without overflow.
+ *
+ * @param count
+ */
+
+void HugeIntAccumulator::reserve(std::uint64_t count) {
+    if (additions_ + count > maxAdditions) {
+        normalize();
+    }
+}
+
+} /* namespace iota */
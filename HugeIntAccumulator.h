@@ -0,0 +1,73 @@
+/*
+ * HugeIntAccumulator.h
+ *
+ * Accumulation of long sums of HugeInts and of products of HugeInts, with
+ * deferred carries.
+ *
+ * The running total is held as two arrays of N 64-bit slots, one per base
+ * 2^32 digit, for the terms added and the terms subtracted; the total is
+ * their difference. Adding a HugeInt adds each of its 32-bit digits to the
+ * corresponding slot without propagating any carry, so the additions are
+ * independent of one another (and vectorize), rather than forming a carry
+ * chain through all N digits. Negative values are added as their radix
+ * complements, as with operator+. addmul(a, b) adds the 64-bit digit
+ * products of |a| and |b| in the same way, as the low and high 32-bit
+ * halves to adjacent slots (of the second array if a b < 0), so that a sum
+ * of products (a dot product, or a ledger of quantities times prices)
+ * needs no carries either.
+ *
+ * A slot that starts below 2^32 can absorb 2^32 - 1 further 32-bit
+ * additions without overflowing, so the carries are propagated (and the
+ * slots brought back below 2^32) only after that many additions, or when
+ * the total is read.
+ *
+ * As with the arithmetic operators, the total is exact modulo (2^32)^N and
+ * silently truncated if it is not representable.
+ */
+
+#ifndef HUGEINTACCUMULATOR_H
+#define HUGEINTACCUMULATOR_H
+
+#include "HugeInt.h"
+#include <cstdint>
+
+namespace iota {
+
+class HugeIntAccumulator {
+public:
+    HugeIntAccumulator() = default;
+    explicit HugeIntAccumulator(const HugeInt&);
+
+    // accumulation
+    HugeIntAccumulator& add(const HugeInt&);
+    HugeIntAccumulator& add(long long int);
+    HugeIntAccumulator& add(const HugeIntAccumulator&);
+    HugeIntAccumulator& subtract(const HugeInt&);
+    HugeIntAccumulator& addmul(const HugeInt&, const HugeInt&);
+    HugeIntAccumulator& operator+=(const HugeInt&);
+    HugeIntAccumulator& operator+=(const HugeIntAccumulator&);
+    HugeIntAccumulator& operator-=(const HugeInt&);
+
+    // the total so far
+    HugeInt value() const;
+    void    clear();
+
+    // algorithm threshold (default in HugeIntTuning.h)
+    static void setProductCutoff(int);
+    static int  getProductCutoff();
+
+private:
+    std::uint64_t positive_[HugeInt::numDigits_]{0};
+    std::uint64_t negative_[HugeInt::numDigits_]{0};
+    std::uint64_t additions_{0};   // max. 32-bit additions to any slot since
+                                   // normalization
+
+    // private utility functions
+    void accumulate(const HugeInt&, bool);
+    void normalize();
+    void reserve(std::uint64_t);
+};
+
+} /* namespace iota */
+
+#endif /* HUGEINTACCUMULATOR_H */
@@ -0,0 +1,236 @@
+/*
+ * HugeIntExecutor.cpp
+ *
+ * Implementation of the HugeIntExecutor class. See comments in
+ * HugeIntExecutor.h for details.
+ *
+ */
+
+#include "HugeIntExecutor.h"
+#include <algorithm>
+#include <stdexcept>
+
+
+/*
+ * Non-member utility functions (in anonymous namespace -- file scope only).
+ *
+ */
+
+namespace { /* anonymous namespace */
+
+// the executor and queue index of the worker running on this thread, if any
+thread_local const iota::HugeIntExecutor* currentExecutor{nullptr};
+thread_local unsigned int                 currentWorker{0};
+
+} /* anonymous namespace */
+
+
+
+namespace iota {
+
+/**
+ * Constructor
+ *
+ * Start a pool of the given number of worker threads (at least one).
+ *
+ * @param threads
+ */
+
+HugeIntExecutor::HugeIntExecutor(unsigned int threads) {
+    threads = std::max(1U, threads);
+
+    for (unsigned int i = 0; i < threads; ++i) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+
+    for (unsigned int i = 0; i < threads; ++i) {
+        workers_.emplace_back(&HugeIntExecutor::run, this, i);
+    }
+}
+
+/**
+ * Destructor
+ *
+ * Run all tasks already submitted, then stop and join the workers.
+ *
+ */
+
+HugeIntExecutor::~HugeIntExecutor() {
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        stopping_ = true;
+    }
+    wakeup_.notify_all();
+
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+/**
+ * submit
+ *
+ * Queue the binary operation a op b and return a future for its result.
+ * Division by zero is reported through the future as std::domain_error.
+ *
+ * @param op
+ * @param a
+ * @param b
+ * @return
+ */
+
+std::future<HugeInt> HugeIntExecutor::submit(Operation op, const HugeInt& a,
+                                             const HugeInt& b) {
+    return submit([op, a, b]() -> HugeInt {
+        switch (op) {
+            case Operation::add:
+                return a + b;
+            case Operation::subtract:
+                return a - b;
+            case Operation::multiply:
+                return a * b;
+            case Operation::divide:
+            case Operation::modulo:
+                if (b.isZero()) {
+                    throw std::domain_error{"HugeInt division by zero."};
+                }
+                return op == Operation::divide ? a / b : a % b;
+        }
+
+        throw std::invalid_argument{"Unknown HugeIntExecutor operation."};
+    });
+}
+
+/**
+ * size()
+ *
+ * Return the number of worker threads: the number of queues, which (unlike
+ * workers_) is complete before the first worker starts.
+ *
+ * @return
+ */
+
+unsigned int HugeIntExecutor::size() const {
+    return static_cast<unsigned int>(queues_.size());
+}
+
+/**
+ * defaultThreads()
+ *
+ * Return the default number of worker threads: one per hardware thread.
+ * Static member function.
+ *
+ * @return
+ */
+
+unsigned int HugeIntExecutor::defaultThreads() {
+    return std::max(1U, std::thread::hardware_concurrency());
+}
+
+/**
+ * push: (private utility function)
+ *
+ * Place a task on the back of the current worker's queue, if called from
+ * one of this executor's workers, and otherwise on the next queue in turn,
+ * then wake a sleeping worker, if there is one. The count of pending tasks
+ * is raised under the queue's lock, once the task is on the queue, so that
+ * a worker never sees a task pending that it cannot yet take, and never
+ * takes a task before it is counted. mutex_ is locked only to wake a
+ * sleeper: a worker registers as a sleeper before it checks the count, and
+ * push checks for sleepers after raising it, so one of the two always sees
+ * the other.
+ *
+ * @param task
+ */
+
+void HugeIntExecutor::push(std::function<void()> task) {
+    const unsigned int index{currentExecutor == this ? currentWorker
+                             : nextQueue_++ % size()};
+
+    {
+        Queue&                      queue{*queues_[index]};
+        std::lock_guard<std::mutex> lock{queue.mutex};
+        queue.tasks.push_back(std::move(task));
+        ++pending_;
+    }
+
+    if (sleepers_ > 0) {
+        {
+            // a sleeper between its check and its wait holds mutex_
+            std::lock_guard<std::mutex> lock{mutex_};
+        }
+        wakeup_.notify_one();
+    }
+}
+
+/**
+ * take: (private utility function)
+ *
+ * Take a task for the worker with the given index: the newest task on its
+ * own queue or, failing that, the oldest task on another worker's queue,
+ * visiting them in turn from the next index. Returns false if all queues
+ * are empty.
+ *
+ * @param index
+ * @param task
+ * @return
+ */
+
+bool HugeIntExecutor::take(unsigned int index, std::function<void()>& task) {
+    const unsigned int n{size()};
+    bool               found{false};
+
+    for (unsigned int k = 0; k < n && !found; ++k) {
+        Queue&                      queue{*queues_[(index + k) % n]};
+        std::lock_guard<std::mutex> lock{queue.mutex};
+
+        if (!queue.tasks.empty()) {
+            if (k == 0) {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+            else {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            --pending_;
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+/**
+ * run: (private utility function)
+ *
+ * Body of the worker thread with the given index: run tasks while any are
+ * queued, and otherwise sleep, counted in sleepers_, until one is
+ * submitted or the executor is stopping with nothing left to do.
+ *
+ * @param index
+ */
+
+void HugeIntExecutor::run(unsigned int index) {
+    currentExecutor = this;
+    currentWorker = index;
+
+    for (;;) {
+        std::function<void()> task;
+
+        if (take(index, task)) {
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock{mutex_};
+        ++sleepers_;
+        wakeup_.wait(lock, [this] { return pending_ > 0 || stopping_; });
+        --sleepers_;
+        if (pending_ == 0 && stopping_) {
+            return;
+        }
+    }
+}
+
+} /* namespace iota */
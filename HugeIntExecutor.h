@@ -0,0 +1,118 @@
+/*
+ * HugeIntExecutor.h
+ *
+ * A fixed pool of worker threads for running many independent HugeInt jobs
+ * (parsing, arithmetic, formatting, ...).
+ *
+ * Each worker owns a double-ended queue of tasks. A task submitted from
+ * outside the pool is placed on the workers' queues in turn; a task
+ * submitted by a task running on a worker goes on that worker's own queue.
+ * A worker takes tasks from the back of its own queue (most recent first,
+ * while their operands are still in cache) and, when that is empty, steals
+ * from the front of the other workers' queues (oldest first), so that idle
+ * workers take over the backlog of busy ones. Workers with nothing to do
+ * sleep until a task is submitted.
+ *
+ * Jobs are submitted either as callables, whose result (or exception) is
+ * returned through a std::future, or as small descriptors naming a binary
+ * HugeInt operation and its operands. The scratch space of the HugeInt
+ * multiplication kernels is held per thread, so workers share no buffers.
+ *
+ * The destructor runs every task already submitted before joining the
+ * workers.
+ *
+ * WARNING: a task that waits on the future of another task holds up its
+ * worker meanwhile, and deadlocks if every worker is doing the same.
+ */
+
+#ifndef HUGEINTEXECUTOR_H
+#define HUGEINTEXECUTOR_H
+
+#include "HugeInt.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace iota {
+
+class HugeIntExecutor {
+public:
+    // binary operations that may be submitted as descriptors
+    enum class Operation {
+        add,
+        subtract,
+        multiply,
+        divide,
+        modulo
+    };
+
+    explicit HugeIntExecutor(unsigned int threads = defaultThreads());
+    ~HugeIntExecutor();
+
+    HugeIntExecutor(const HugeIntExecutor&) = delete;
+    HugeIntExecutor& operator=(const HugeIntExecutor&) = delete;
+
+    // submission of jobs
+    template <typename Function>
+    auto submit(Function&&) -> std::future<decltype(std::declval<Function&>()())>;
+    std::future<HugeInt> submit(Operation, const HugeInt&, const HugeInt&);
+
+    // informational
+    unsigned int        size() const;
+    static unsigned int defaultThreads();
+
+private:
+    struct Queue {
+        std::mutex                        mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread>            workers_;
+    std::atomic<unsigned int>           nextQueue_{0};  // for outside jobs
+    std::mutex                          mutex_;         // guards sleeping
+    std::condition_variable             wakeup_;
+    std::atomic<std::size_t>            pending_{0};    // queued tasks
+    std::atomic<unsigned int>           sleepers_{0};   // workers waiting
+    bool                                stopping_{false};
+
+    // private utility functions
+    void push(std::function<void()>);
+    bool take(unsigned int, std::function<void()>&);
+    void run(unsigned int);
+};
+
+/**
+ * submit
+ *
+ * Queue function() to be run on a worker and return a future for its
+ * result. An exception thrown by the function is stored in the future.
+ *
+ * @param function
+ * @return
+ */
+
+template <typename Function>
+auto HugeIntExecutor::submit(Function&& function)
+    -> std::future<decltype(std::declval<Function&>()())> {
+    using Result = decltype(std::declval<Function&>()());
+
+    auto task = std::make_shared<std::packaged_task<Result()>>(
+                    std::forward<Function>(function));
+    std::future<Result> result{task->get_future()};
+
+    push([task] { (*task)(); });
+
+    return result;
+}
+
+} /* namespace iota */
+
+#endif /* HUGEINTEXECUTOR_H */
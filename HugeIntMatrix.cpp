@@ -0,0 +1,758 @@
+/*
+ * HugeIntMatrix.cpp
+ *
+ * Implementation of the HugeIntMatrix class and the dot product. See
+ * comments in HugeIntMatrix.h for details.
+ *
+ */
+
+#include "HugeIntMatrix.h"
+#include "HugeIntAccumulator.h"
+#include <algorithm>
+#include <cstdint>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+
+/*
+ * Non-member utility functions (in anonymous namespace -- file scope only).
+ *
+ */
+
+namespace { /* anonymous namespace */
+
+using iota::HugeInt;
+
+// side of the square tiles of a matrix product
+const std::size_t tileSize{8};
+
+/*
+ * Return the dot product of a[0 .. n) and b[0 .. n).
+ *
+ */
+
+HugeInt dot_product(const HugeInt* a, const HugeInt* b, std::size_t n) {
+    iota::HugeIntAccumulator total;
+
+    for (std::size_t i = 0; i < n; ++i) {
+        total.addmul(a[i], b[i]);
+    }
+
+    return total.value();
+}
+
+/*
+ * Call band(first, last) for consecutive bands of [0, n), each of at least
+ * minimum indices, one per thread for up to the given number of threads.
+ * The last band runs on the calling thread.
+ *
+ */
+
+template <typename Band>
+void for_each_band(std::size_t n, std::size_t minimum, unsigned int threads,
+                   const Band& band) {
+    const std::size_t bands{std::max<std::size_t>(1,
+                                std::min<std::size_t>(threads, n / minimum))};
+
+    std::vector<std::future<void>> running;
+    std::size_t                    first{0};
+
+    for (std::size_t b = 1; b < bands; ++b) {
+        const std::size_t last{first + n / bands};
+        running.push_back(std::async(std::launch::async, band, first, last));
+        first = last;
+    }
+
+    band(first, n);
+    for (std::future<void>& result : running) {
+        result.get();
+    }
+}
+
+/*
+ * Reduce M (rows x columns) in place to row echelon form by fraction-free
+ * (Bareiss) elimination, looking for pivots in the first pivotColumns
+ * columns only, and return the number of pivots found. Rows are swapped to
+ * bring a non-zero pivot into place; sign is set to -1 if the number of
+ * swaps is odd, and to 1 otherwise.
+ *
+ * With p the current pivot and q the previous one, entry (i, j) below the
+ * pivot row r is replaced by (M_ij p - M_ic M_rj) / q, a division that is
+ * exact because both sides are minors of the original matrix (Sylvester's
+ * identity), and so done by divexact. Columns without a pivot are skipped.
+ *
+ */
+
+std::size_t bareiss(iota::HugeIntMatrix& M, std::size_t pivotColumns,
+                    int& sign) {
+    const std::size_t rows{M.getRows()};
+    const std::size_t columns{M.getColumns()};
+    HugeInt           previous{1LL};
+    std::size_t       r{0};
+
+    sign = 1;
+
+    for (std::size_t c = 0; c < pivotColumns && r < rows; ++c) {
+        std::size_t p{r};
+        for ( ; p < rows && M(p, c).isZero(); ++p);
+
+        if (p == rows) {
+            continue;
+        }
+
+        if (p != r) {
+            for (std::size_t j = c; j < columns; ++j) {
+                std::swap(M(p, j), M(r, j));
+            }
+            sign = -sign;
+        }
+
+        const HugeInt pivot{M(r, c)};
+
+        for (std::size_t i = r + 1; i < rows; ++i) {
+            const HugeInt factor{M(i, c)};
+
+            for (std::size_t j = c + 1; j < columns; ++j) {
+                M(i, j) = divexact(M(i, j) * pivot - factor * M(r, j),
+                                   previous);
+            }
+            M(i, c) = 0LL;
+        }
+
+        previous = pivot;
+        ++r;
+    }
+
+    return r;
+}
+
+/*
+ * Return a^e mod m, for m < 2^32.
+ *
+ */
+
+std::uint64_t power_mod(std::uint64_t a, std::uint64_t e, std::uint64_t m) {
+    std::uint64_t result{1};
+
+    for (a %= m; e != 0; e >>= 1) {
+        if (e & 1) {
+            result = result * a % m;
+        }
+        a = a * a % m;
+    }
+
+    return result;
+}
+
+/*
+ * Return true if n < 2^32 is prime, by the Miller-Rabin test to the bases
+ * 2, 7 and 61, which is deterministic below 4759123141.
+ *
+ */
+
+bool is_word_prime(std::uint64_t n) {
+    if (n < 2 || n % 2 == 0) {
+        return n == 2;
+    }
+
+    std::uint64_t d{n - 1};
+    int           s{0};
+    for ( ; d % 2 == 0; d /= 2, ++s);
+
+    for (const std::uint64_t a : {2ULL, 7ULL, 61ULL}) {
+        if (a % n == 0) {
+            continue;
+        }
+
+        std::uint64_t x{power_mod(a, d, n)};
+        if (x == 1 || x == n - 1) {
+            continue;
+        }
+
+        int i{1};
+        for ( ; i < s && x != n - 1; ++i) {
+            x = x * x % n;
+        }
+        if (x != n - 1) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Return the primes below 2^31 in descending order, as many as are needed
+ * for their product to exceed the largest HugeInt. The list is built on
+ * first use.
+ *
+ */
+
+const std::vector<std::uint32_t>& word_primes() {
+    static const std::vector<std::uint32_t> primes{[] {
+        std::vector<std::uint32_t> found;
+        const long                 bits{HugeInt::getMaximum().bitLength()};
+
+        // each prime exceeds 2^30, so contributes more than 30 bits
+        for (std::uint32_t p = 0x7FFFFFFF;
+             30L * static_cast<long>(found.size()) <= bits; p -= 2) {
+            if (is_word_prime(p)) {
+                found.push_back(p);
+            }
+        }
+        return found;
+    }()};
+
+    return primes;
+}
+
+/*
+ * Return x mod p, 0 <= result < p.
+ *
+ */
+
+std::uint64_t residue(const HugeInt& x, std::uint32_t p) {
+    if (!x.isNegative()) {
+        return x.shortModulo(p);
+    }
+
+    const std::uint32_t r{(-x).shortModulo(p)};
+
+    return r == 0 ? 0 : p - r;
+}
+
+/*
+ * Return det A mod p, for a prime p < 2^31, by Gaussian elimination on the
+ * residues of the entries.
+ *
+ */
+
+std::uint64_t det_mod(const iota::HugeIntMatrix& A, std::uint32_t p) {
+    const std::size_t          n{A.getRows()};
+    std::vector<std::uint64_t> M(n * n);
+
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            M[i * n + j] = residue(A(i, j), p);
+        }
+    }
+
+    std::uint64_t det{1};
+
+    for (std::size_t c = 0; c < n; ++c) {
+        std::size_t r{c};
+        for ( ; r < n && M[r * n + c] == 0; ++r);
+
+        if (r == n) {
+            return 0;
+        }
+
+        if (r != c) {
+            for (std::size_t j = c; j < n; ++j) {
+                std::swap(M[r * n + j], M[c * n + j]);
+            }
+            det = p - det;
+        }
+
+        const std::uint64_t pivot{M[c * n + c]};
+        const std::uint64_t inverse{power_mod(pivot, p - 2, p)};
+
+        det = det * pivot % p;
+
+        for (std::size_t i = c + 1; i < n; ++i) {
+            const std::uint64_t factor{M[i * n + c] * inverse % p};
+
+            if (factor == 0) {
+                continue;
+            }
+            for (std::size_t j = c + 1; j < n; ++j) {
+                M[i * n + j] = (M[i * n + j] + (p - factor) * M[c * n + j]) % p;
+            }
+        }
+    }
+
+    return det;
+}
+
+/*
+ * Return an upper bound on log2 |det A| from Hadamard's inequality, with
+ * ||row_i|| <= sqrt(n) max_j |A_ij|.
+ *
+ */
+
+long hadamard_bits(const iota::HugeIntMatrix& A) {
+    const std::size_t n{A.getRows()};
+    int               halfLogN{0};
+    for ( ; (std::size_t{1} << (2 * halfLogN)) < n; ++halfLogN);
+
+    long bits{0};
+
+    for (std::size_t i = 0; i < n; ++i) {
+        int longest{0};
+
+        for (std::size_t j = 0; j < n; ++j) {
+            const HugeInt& a{A(i, j)};
+            longest = std::max(longest, (a.isNegative() ? -a : a).bitLength());
+        }
+        bits += longest + halfLogN;
+    }
+
+    return bits;
+}
+
+/*
+ * Throw std::invalid_argument unless A is square.
+ *
+ */
+
+void check_square(const iota::HugeIntMatrix& A) {
+    if (A.getRows() != A.getColumns()) {
+        throw std::invalid_argument{"HugeIntMatrix is not square."};
+    }
+}
+
+} /* anonymous namespace */
+
+
+
+namespace iota {
+
+/**
+ * Constructor: a rows x columns matrix of zeros.
+ *
+ * @param rows
+ * @param columns
+ */
+
+HugeIntMatrix::HugeIntMatrix(std::size_t rows, std::size_t columns)
+    : rows_{rows}, columns_{columns}, entries_(rows * columns) {
+}
+
+/**
+ * Constructor: a matrix from a list of rows, e.g., {{1, 2}, {3, 4}}. Throws
+ * std::invalid_argument if the rows are not all of the same length.
+ *
+ * @param rows
+ */
+
+HugeIntMatrix::HugeIntMatrix(
+        std::initializer_list<std::initializer_list<HugeInt>> rows)
+    : rows_{rows.size()}, columns_{rows.size() ? rows.begin()->size() : 0} {
+    entries_.reserve(rows_ * columns_);
+
+    for (const std::initializer_list<HugeInt>& row : rows) {
+        if (row.size() != columns_) {
+            throw std::invalid_argument{"HugeIntMatrix rows of unequal length."};
+        }
+        entries_.insert(entries_.end(), row.begin(), row.end());
+    }
+}
+
+/**
+ * identity()
+ *
+ * Return the n x n identity matrix. Static member function.
+ *
+ * @param n
+ * @return
+ */
+
+HugeIntMatrix HugeIntMatrix::identity(std::size_t n) {
+    HugeIntMatrix result{n, n};
+
+    for (std::size_t i = 0; i < n; ++i) {
+        result(i, i) = 1LL;
+    }
+
+    return result;
+}
+
+/**
+ * operator()
+ *
+ * Return the entry in the given row and column (not range checked).
+ *
+ * @param i
+ * @param j
+ * @return
+ */
+
+HugeInt& HugeIntMatrix::operator()(std::size_t i, std::size_t j) {
+    return entries_[i * columns_ + j];
+}
+
+const HugeInt& HugeIntMatrix::operator()(std::size_t i, std::size_t j) const {
+    return entries_[i * columns_ + j];
+}
+
+/**
+ * multiply
+ *
+ * Return the matrix product AB, using up to the given number of threads.
+ * B is transposed, so that each entry of the product is the dot product of
+ * two contiguous rows, and the product is formed tile by tile in bands of
+ * rows. Throws std::invalid_argument if the dimensions do not agree.
+ *
+ * @param A
+ * @param B
+ * @param threads
+ * @return
+ */
+
+HugeIntMatrix multiply(const HugeIntMatrix& A, const HugeIntMatrix& B,
+                       unsigned int threads) {
+    if (A.columns_ != B.rows_) {
+        throw std::invalid_argument{"HugeIntMatrix dimensions do not agree."};
+    }
+
+    const HugeIntMatrix Bt{B.transpose()};
+    const std::size_t   n{A.columns_};
+    HugeIntMatrix       C{A.rows_, B.columns_};
+
+    for_each_band(A.rows_, tileSize, threads,
+                  [&](std::size_t first, std::size_t last) {
+        for (std::size_t i0 = first; i0 < last; i0 += tileSize) {
+            const std::size_t i1{std::min(i0 + tileSize, last)};
+
+            for (std::size_t j0 = 0; j0 < C.columns_; j0 += tileSize) {
+                const std::size_t j1{std::min(j0 + tileSize, C.columns_)};
+
+                for (std::size_t i = i0; i < i1; ++i) {
+                    for (std::size_t j = j0; j < j1; ++j) {
+                        C(i, j) = dot_product(A.row(i), Bt.row(j), n);
+                    }
+                }
+            }
+        }
+    });
+
+    return C;
+}
+
+/**
+ * multiply
+ *
+ * Return the matrix-vector product Ax, using up to the given number of
+ * threads, each computing a band of rows. Throws std::invalid_argument if
+ * the dimensions do not agree.
+ *
+ * @param A
+ * @param x
+ * @param threads
+ * @return
+ */
+
+std::vector<HugeInt> multiply(const HugeIntMatrix& A,
+                              const std::vector<HugeInt>& x,
+                              unsigned int threads) {
+    if (A.columns_ != x.size()) {
+        throw std::invalid_argument{"HugeIntMatrix dimensions do not agree."};
+    }
+
+    std::vector<HugeInt> y(A.rows_);
+
+    for_each_band(A.rows_, tileSize, threads,
+                  [&](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i) {
+            y[i] = dot_product(A.row(i), x.data(), x.size());
+        }
+    });
+
+    return y;
+}
+
+/**
+ * Multiplication operators: multiply with the default number of threads.
+ *
+ * @param A
+ * @param B
+ * @return
+ */
+
+HugeIntMatrix operator*(const HugeIntMatrix& A, const HugeIntMatrix& B) {
+    return multiply(A, B, HugeIntMatrix::defaultThreads());
+}
+
+std::vector<HugeInt> operator*(const HugeIntMatrix& A,
+                               const std::vector<HugeInt>& x) {
+    return multiply(A, x, HugeIntMatrix::defaultThreads());
+}
+
+/**
+ * Relational operators
+ *
+ * @param A
+ * @param B
+ * @return
+ */
+
+bool operator==(const HugeIntMatrix& A, const HugeIntMatrix& B) {
+    return A.rows_ == B.rows_ && A.columns_ == B.columns_ &&
+           A.entries_ == B.entries_;
+}
+
+bool operator!=(const HugeIntMatrix& A, const HugeIntMatrix& B) {
+    return !(A == B);
+}
+
+/**
+ * getRows()
+ *
+ * @return
+ */
+
+std::size_t HugeIntMatrix::getRows() const {
+    return rows_;
+}
+
+/**
+ * getColumns()
+ *
+ * @return
+ */
+
+std::size_t HugeIntMatrix::getColumns() const {
+    return columns_;
+}
+
+/**
+ * transpose()
+ *
+ * @return
+ */
+
+HugeIntMatrix HugeIntMatrix::transpose() const {
+    HugeIntMatrix result{columns_, rows_};
+
+    for (std::size_t i = 0; i < rows_; ++i) {
+        for (std::size_t j = 0; j < columns_; ++j) {
+            result(j, i) = (*this)(i, j);
+        }
+    }
+
+    return result;
+}
+
+/**
+ * defaultThreads()
+ *
+ * Return the default number of threads for matrix products: one per
+ * hardware thread. Static member function.
+ *
+ * @return
+ */
+
+unsigned int HugeIntMatrix::defaultThreads() {
+    return std::max(1U, std::thread::hardware_concurrency());
+}
+
+/**
+ * row: (private utility function)
+ *
+ * Return a pointer to the first entry of row i.
+ *
+ * @param i
+ * @return
+ */
+
+const HugeInt* HugeIntMatrix::row(std::size_t i) const {
+    return entries_.data() + i * columns_;
+}
+
+/**
+ * dot:
+ *
+ * Return the dot product of two vectors of equal length, accumulated
+ * without intermediate carries (see HugeIntAccumulator). Throws
+ * std::invalid_argument if the lengths differ.
+ *
+ * @param a
+ * @param b
+ * @return
+ */
+
+HugeInt dot(const std::vector<HugeInt>& a, const std::vector<HugeInt>& b) {
+    if (a.size() != b.size()) {
+        throw std::invalid_argument{"dot product of unequal lengths."};
+    }
+
+    return dot_product(a.data(), b.data(), a.size());
+}
+
+/**
+ * det:
+ *
+ * Return the determinant of the square matrix A, by det_multimodular if A
+ * has at least modularCutoff rows and by det_bareiss otherwise.
+ *
+ * @param A
+ * @return
+ */
+
+HugeInt det(const HugeIntMatrix& A) {
+    return A.getRows() >= modularCutoff ? det_multimodular(A) : det_bareiss(A);
+}
+
+/**
+ * det_bareiss:
+ *
+ * Return the determinant of the square matrix A by fraction-free
+ * elimination: the last pivot, up to the sign of the row swaps. Throws
+ * std::invalid_argument if A is not square.
+ *
+ * @param A
+ * @return
+ */
+
+HugeInt det_bareiss(const HugeIntMatrix& A) {
+    check_square(A);
+
+    const std::size_t n{A.getRows()};
+    if (n == 0) {
+        return 1LL;
+    }
+
+    HugeIntMatrix M{A};
+    int           sign;
+
+    if (bareiss(M, n, sign) < n) {
+        return 0LL;
+    }
+
+    return sign > 0 ? M(n - 1, n - 1) : -M(n - 1, n - 1);
+}
+
+/**
+ * det_multimodular:
+ *
+ * Return the determinant of the square matrix A from its residues modulo
+ * the largest primes below 2^31, as many as needed for their product to
+ * exceed twice the Hadamard bound on |det A|, computed using up to the given
+ * number of threads. The residues are combined by Garner's algorithm and
+ * the result taken in the symmetric range. If the product of the primes
+ * would not be representable, det_bareiss is used instead. Throws
+ * std::invalid_argument if A is not square.
+ *
+ * @param A
+ * @param threads
+ * @return
+ */
+
+HugeInt det_multimodular(const HugeIntMatrix& A, unsigned int threads) {
+    check_square(A);
+
+    // each prime exceeds 2^30, so contributes more than 30 bits
+    const long bits{hadamard_bits(A) + 2};
+    if (bits > HugeInt::getMaximum().bitLength() - 64) {
+        return det_bareiss(A);
+    }
+
+    const std::vector<std::uint32_t>& primes{word_primes()};
+    const std::size_t                 count(bits / 30 + 1);
+    std::vector<std::uint64_t>        residues(count);
+
+    for_each_band(count, 1, threads, [&](std::size_t first, std::size_t last) {
+        for (std::size_t k = first; k < last; ++k) {
+            residues[k] = det_mod(A, primes[k]);
+        }
+    });
+
+    // Garner's algorithm, as crt, but with the residues taken in words
+    HugeInt x{0LL};
+    HugeInt product{1LL};
+
+    for (std::size_t k = 0; k < count; ++k) {
+        const std::uint64_t p{primes[k]};
+        const std::uint64_t t{(residues[k] + p - x.shortModulo(primes[k])) % p
+                              * power_mod(product.shortModulo(primes[k]),
+                                          p - 2, p) % p};
+
+        x += product * static_cast<long long>(t);
+        product *= static_cast<long long>(p);
+    }
+
+    return 2LL * x > product ? x - product : x;
+}
+
+/**
+ * rank:
+ *
+ * Return the rank of A (of any shape), the number of pivots found by
+ * fraction-free elimination.
+ *
+ * @param A
+ * @return
+ */
+
+std::size_t rank(const HugeIntMatrix& A) {
+    HugeIntMatrix M{A};
+    int           sign;
+
+    return bareiss(M, M.getColumns(), sign);
+}
+
+/**
+ * solve:
+ *
+ * Return the solution x of Ax = b for a non-singular square matrix A, as
+ * Rationals in lowest terms. The augmented matrix [A | b] is reduced by
+ * fraction-free elimination to an upper triangular system U x = c whose
+ * last pivot is d = +/- det A; the integers y = d x are then found by
+ * back-substitution,
+ *
+ *     y_i = (d c_i - sum_{j > i} U_ij y_j) / U_ii,
+ *
+ * in which every division is exact, and x = y / d. Throws
+ * std::invalid_argument if A is not square or b has the wrong length, and
+ * std::domain_error if A is singular.
+ *
+ * @param A
+ * @param b
+ * @return
+ */
+
+std::vector<Rational> solve(const HugeIntMatrix& A,
+                            const std::vector<HugeInt>& b) {
+    check_square(A);
+
+    const std::size_t n{A.getRows()};
+    if (b.size() != n) {
+        throw std::invalid_argument{"HugeIntMatrix dimensions do not agree."};
+    }
+
+    HugeIntMatrix M{n, n + 1};
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            M(i, j) = A(i, j);
+        }
+        M(i, n) = b[i];
+    }
+
+    int sign;
+    if (bareiss(M, n, sign) < n) {
+        throw std::domain_error{"solve with a singular matrix."};
+    }
+
+    const HugeInt        d{M(n - 1, n - 1)};
+    std::vector<HugeInt> y(n);
+
+    for (std::size_t i = n; i-- > 0; ) {
+        HugeInt t{d * M(i, n)};
+
+        for (std::size_t j = i + 1; j < n; ++j) {
+            t -= M(i, j) * y[j];
+        }
+        y[i] = divexact(t, M(i, i));
+    }
+
+    std::vector<Rational> x;
+    for (const HugeInt& numerator : y) {
+        x.emplace_back(numerator, d);
+        x.back().normalize();
+    }
+
+    return x;
+}
+
+} /* namespace iota */
@@ -0,0 +1,112 @@
+/*
+ * HugeIntMatrix.h
+ *
+ * Dense matrices of HugeInts, and exact dot products and matrix products.
+ *
+ * dot(a, b) adds every product a_i b_i to a single HugeIntAccumulator, so
+ * the digit products are accumulated without carries and without forming
+ * the n products as HugeInt temporaries; the carries are propagated once,
+ * when the total is read.
+ *
+ * Every entry of a matrix-vector or matrix-matrix product is such a dot
+ * product of a row of the left operand with a column of the right operand
+ * (the right matrix is first transposed so that its columns are contiguous
+ * too). A matrix product is computed in square tiles of the result: the
+ * rows and columns that make up a tile are used tileSize times each while
+ * they are in cache, rather than once per pass over the whole matrix. The
+ * rows of the result are divided into bands, one per thread, and the bands
+ * computed concurrently.
+ *
+ * det, rank and solve use fraction-free (Bareiss) elimination: each step
+ * replaces an entry by a 2 x 2 determinant divided exactly by the previous
+ * pivot, so that every entry is a minor of the original matrix and the
+ * entries grow only linearly in size, with no gcds and no fractions. The
+ * solution of Ax = b is returned as Rationals, from the fraction-free
+ * back-substitution for the integers det(A) x.
+ *
+ * det_multimodular instead computes the determinant modulo as many word-size
+ * primes as its Hadamard bound, |det A| <= prod_i ||row_i||, requires, by
+ * Gaussian elimination on machine words (the primes handled concurrently),
+ * and recovers it by Chinese remaindering. For all but small matrices this
+ * is faster than Bareiss elimination on HugeInts, and det chooses it when
+ * n >= modularCutoff.
+ *
+ * As with the arithmetic operators, entries that are not representable are
+ * silently truncated. Note that the products formed by Bareiss elimination
+ * are about twice the size of the minors, so det_bareiss, rank and solve
+ * need |det A|^2 to be representable; det_multimodular needs only |det A|.
+ */
+
+#ifndef HUGEINTMATRIX_H
+#define HUGEINTMATRIX_H
+
+#include "HugeInt.h"
+#include "HugeIntTuning.h"
+#include "Rational.h"
+#include <cstddef>
+#include <initializer_list>
+#include <vector>
+
+namespace iota {
+
+class HugeIntMatrix {
+public:
+    HugeIntMatrix() = default;
+    HugeIntMatrix(std::size_t, std::size_t);    // rows x columns of zeros
+    HugeIntMatrix(std::initializer_list<std::initializer_list<HugeInt>>);
+
+    static HugeIntMatrix identity(std::size_t);
+
+    // element access (row, column)
+    HugeInt&       operator()(std::size_t, std::size_t);
+    const HugeInt& operator()(std::size_t, std::size_t) const;
+
+    // matrix products, using up to the given number of threads
+    friend HugeIntMatrix        multiply(const HugeIntMatrix&,
+                                         const HugeIntMatrix&, unsigned int);
+    friend std::vector<HugeInt> multiply(const HugeIntMatrix&,
+                                         const std::vector<HugeInt>&,
+                                         unsigned int);
+
+    friend HugeIntMatrix        operator*(const HugeIntMatrix&,
+                                          const HugeIntMatrix&);
+    friend std::vector<HugeInt> operator*(const HugeIntMatrix&,
+                                          const std::vector<HugeInt>&);
+
+    // relational operators
+    friend bool operator==(const HugeIntMatrix&, const HugeIntMatrix&);
+    friend bool operator!=(const HugeIntMatrix&, const HugeIntMatrix&);
+
+    // informational
+    std::size_t   getRows() const;
+    std::size_t   getColumns() const;
+    HugeIntMatrix transpose() const;
+
+    static unsigned int defaultThreads();
+
+private:
+    std::size_t          rows_{0};
+    std::size_t          columns_{0};
+    std::vector<HugeInt> entries_;      // row-major
+
+    // private utility functions
+    const HugeInt* row(std::size_t) const;
+};
+
+// exact dot product of two vectors of equal length
+HugeInt dot(const std::vector<HugeInt>&, const std::vector<HugeInt>&);
+
+// exact elimination (square matrices, except for rank)
+HugeInt     det(const HugeIntMatrix&);
+HugeInt     det_bareiss(const HugeIntMatrix&);
+HugeInt     det_multimodular(const HugeIntMatrix&,
+                             unsigned int = HugeIntMatrix::defaultThreads());
+std::size_t rank(const HugeIntMatrix&);
+std::vector<Rational> solve(const HugeIntMatrix&, const std::vector<HugeInt>&);
+
+// no. rows from which det uses det_multimodular
+const std::size_t modularCutoff{tuning::modularCutoff};
+
+} /* namespace iota */
+
+#endif /* HUGEINTMATRIX_H */
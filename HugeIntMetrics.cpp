@@ -0,0 +1,326 @@
+/*
+ * HugeIntMetrics.cpp
+ *
+ * Implementation of the HugeIntMetrics class. See comments in
+ * HugeIntMetrics.h for details.
+ *
+ */
+
+#include "HugeIntMetrics.h"
+#include <atomic>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+/*
+ * Non-member utility functions (in anonymous namespace -- file scope only).
+ *
+ */
+
+namespace { /* anonymous namespace */
+
+using iota::HugeIntMetrics;
+
+// the counters of one thread, read by snapshot() from other threads
+struct AtomicCounts {
+    std::atomic<std::uint64_t> count{0};
+    std::atomic<std::uint64_t> nanoseconds{0};
+    std::atomic<std::uint64_t> totalLimbs{0};
+    std::atomic<std::uint64_t> limbs[HugeIntMetrics::limbBuckets]{};
+    std::atomic<std::uint64_t> latency[HugeIntMetrics::latencyBuckets]{};
+};
+
+using ThreadCounts = AtomicCounts[HugeIntMetrics::numOperations];
+
+// the counters of the running threads, and the totals of those that exited
+std::mutex                 registryMutex;
+std::vector<ThreadCounts*> registry;
+HugeIntMetrics::Snapshot   retired;
+
+/*
+ * Add the counters c to the totals t.
+ *
+ */
+
+void add_counts(const AtomicCounts& c, HugeIntMetrics::Counts& t) {
+    t.count += c.count.load(std::memory_order_relaxed);
+    t.nanoseconds += c.nanoseconds.load(std::memory_order_relaxed);
+    t.totalLimbs += c.totalLimbs.load(std::memory_order_relaxed);
+
+    for (int i = 0; i < HugeIntMetrics::limbBuckets; ++i) {
+        t.limbs[i] += c.limbs[i].load(std::memory_order_relaxed);
+    }
+    for (int i = 0; i < HugeIntMetrics::latencyBuckets; ++i) {
+        t.latency[i] += c.latency[i].load(std::memory_order_relaxed);
+    }
+}
+
+/*
+ * Zero the counters c.
+ *
+ */
+
+void clear_counts(AtomicCounts& c) {
+    c.count.store(0, std::memory_order_relaxed);
+    c.nanoseconds.store(0, std::memory_order_relaxed);
+    c.totalLimbs.store(0, std::memory_order_relaxed);
+
+    for (std::atomic<std::uint64_t>& bucket : c.limbs) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    for (std::atomic<std::uint64_t>& bucket : c.latency) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+/*
+ * The counters of the calling thread, registered while the thread runs.
+ *
+ */
+
+struct Registration {
+    ThreadCounts counts;
+
+    Registration() {
+        std::lock_guard<std::mutex> lock{registryMutex};
+        registry.push_back(&counts);
+    }
+
+    ~Registration() {
+        std::lock_guard<std::mutex> lock{registryMutex};
+
+        for (int op = 0; op < HugeIntMetrics::numOperations; ++op) {
+            add_counts(counts[op], retired[op]);
+        }
+        for (std::size_t i = 0; i < registry.size(); ++i) {
+            if (registry[i] == &counts) {
+                registry.erase(registry.begin() + i);
+                break;
+            }
+        }
+    }
+};
+
+/*
+ * Return the bucket for x: the least i < buckets - 1 with x <= 2^(i + shift),
+ * or else buckets - 1.
+ *
+ */
+
+int bucket(std::uint64_t x, int shift, int buckets) {
+    int i{0};
+    for ( ; i < buckets - 1 && x > (std::uint64_t{1} << (i + shift)); ++i);
+
+    return i;
+}
+
+/*
+ * Write x / 10^decimals exactly, in fixed-point notation without trailing
+ * zeros (so that large bounds and sums are not rounded to 6 significant
+ * digits, as they would be as doubles).
+ *
+ */
+
+void write_scaled(std::ostringstream& output, std::uint64_t x, int decimals) {
+    std::string digits{std::to_string(x)};
+
+    if (static_cast<int>(digits.size()) <= decimals) {
+        digits.insert(0, decimals + 1 - digits.size(), '0');
+    }
+
+    std::string fraction{digits.substr(digits.size() - decimals)};
+    while (!fraction.empty() && fraction.back() == '0') {
+        fraction.pop_back();
+    }
+
+    output << digits.substr(0, digits.size() - decimals);
+    if (!fraction.empty()) {
+        output << '.' << fraction;
+    }
+}
+
+/*
+ * Write one Prometheus histogram of integer observations (sum) in units of
+ * 10^-decimals, with buckets of upper bounds 2^shift, 2^(shift + 1), ...,
+ * +Inf units.
+ *
+ */
+
+void write_histogram(std::ostringstream& output, const char* metric,
+                     const char* operation, const std::uint64_t* buckets,
+                     int n, int shift, int decimals, std::uint64_t sum,
+                     std::uint64_t count) {
+    std::uint64_t cumulative{0};
+
+    for (int i = 0; i < n; ++i) {
+        cumulative += buckets[i];
+        output << metric << "_bucket{operation=\"" << operation << "\",le=\"";
+        if (i < n - 1) {
+            write_scaled(output, std::uint64_t{1} << (i + shift), decimals);
+        }
+        else {
+            output << "+Inf";
+        }
+        output << "\"} " << cumulative << '\n';
+    }
+
+    output << metric << "_sum{operation=\"" << operation << "\"} ";
+    write_scaled(output, sum, decimals);
+    output << '\n' << metric << "_count{operation=\"" << operation << "\"} "
+           << count << '\n';
+}
+
+} /* anonymous namespace */
+
+
+
+namespace iota {
+
+/**
+ * record:
+ *
+ * Count one operation of the given kind, on operands of at most the given
+ * number of limbs, that took the given number of ns. Static member
+ * function.
+ *
+ * @param operation
+ * @param limbs
+ * @param nanoseconds
+ */
+
+void HugeIntMetrics::record(Operation operation, int limbs,
+                            std::uint64_t nanoseconds) {
+    thread_local Registration registration;
+    AtomicCounts&             counts{registration.counts[operation]};
+
+    counts.count.fetch_add(1, std::memory_order_relaxed);
+    counts.nanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+    counts.totalLimbs.fetch_add(limbs, std::memory_order_relaxed);
+    counts.limbs[bucket(limbs, 0, limbBuckets)]
+        .fetch_add(1, std::memory_order_relaxed);
+    counts.latency[bucket(nanoseconds, 4, latencyBuckets)]
+        .fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * snapshot:
+ *
+ * Return the totals of the counters of all threads, running and exited.
+ * Static member function.
+ *
+ * @return
+ */
+
+HugeIntMetrics::Snapshot HugeIntMetrics::snapshot() {
+    std::lock_guard<std::mutex> lock{registryMutex};
+    Snapshot                    totals{retired};
+
+    for (const ThreadCounts* counts : registry) {
+        for (int op = 0; op < numOperations; ++op) {
+            add_counts((*counts)[op], totals[op]);
+        }
+    }
+
+    return totals;
+}
+
+/**
+ * reset:
+ *
+ * Zero the counters of all threads. Static member function.
+ *
+ */
+
+void HugeIntMetrics::reset() {
+    std::lock_guard<std::mutex> lock{registryMutex};
+
+    retired = Snapshot{};
+    for (ThreadCounts* counts : registry) {
+        for (AtomicCounts& c : *counts) {
+            clear_counts(c);
+        }
+    }
+}
+
+/**
+ * toPrometheus:
+ *
+ * Return the snapshot in the Prometheus text exposition format. Static
+ * member function.
+ *
+ * @param snapshot
+ * @return
+ */
+
+std::string HugeIntMetrics::toPrometheus(const Snapshot& snapshot) {
+    std::ostringstream output;
+
+    output << "# HELP hugeint_operations_total HugeInt operations performed.\n"
+              "# TYPE hugeint_operations_total counter\n";
+    for (int op = 0; op < numOperations; ++op) {
+        output << "hugeint_operations_total{operation=\""
+               << name(static_cast<Operation>(op)) << "\"} "
+               << snapshot[op].count << '\n';
+    }
+
+    output << "# HELP hugeint_operation_seconds Latency of HugeInt "
+              "operations.\n"
+              "# TYPE hugeint_operation_seconds histogram\n";
+    for (int op = 0; op < numOperations; ++op) {
+        const Counts& c{snapshot[op]};
+        write_histogram(output, "hugeint_operation_seconds",
+                        name(static_cast<Operation>(op)), c.latency,
+                        latencyBuckets, 4, 9, c.nanoseconds, c.count);
+    }
+
+    output << "# HELP hugeint_operand_limbs Size of the largest operand of "
+              "HugeInt operations, in 32-bit limbs.\n"
+              "# TYPE hugeint_operand_limbs histogram\n";
+    for (int op = 0; op < numOperations; ++op) {
+        const Counts& c{snapshot[op]};
+        write_histogram(output, "hugeint_operand_limbs",
+                        name(static_cast<Operation>(op)), c.limbs,
+                        limbBuckets, 0, 0, c.totalLimbs, c.count);
+    }
+
+    return output.str();
+}
+
+/**
+ * enabled:
+ *
+ * Return true if the operations were compiled with instrumentation
+ * (HUGEINT_METRICS defined). Static member function.
+ *
+ * @return
+ */
+
+bool HugeIntMetrics::enabled() {
+#ifdef HUGEINT_METRICS
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * name:
+ *
+ * Return the name of the given operation, as used in the Prometheus
+ * labels. Static member function.
+ *
+ * @param operation
+ * @return
+ */
+
+const char* HugeIntMetrics::name(Operation operation) {
+    static const char* const names[numOperations]{
+        "add", "subtract", "multiply", "divide", "modulo", "divexact",
+        "parse", "print"};
+
+    return names[operation];
+}
+
+} /* namespace iota */
@@ -0,0 +1,79 @@
+/*
+ * HugeIntMetrics.h
+ *
+ * Optional instrumentation of the HugeInt operations: for each of addition,
+ * subtraction, multiplication, division, modulus, exact division, parsing
+ * and printing, the number of calls, their total time, and histograms of
+ * their operand sizes (in limbs, i.e., base 2^32 digits) and latencies.
+ *
+ * The instrumentation is compiled into HugeInt.cpp only when the macro
+ * HUGEINT_METRICS is defined (e.g., -DHUGEINT_METRICS for every translation
+ * unit). Otherwise the operations carry no trace of it, and the snapshots
+ * are all zero; enabled() tells which is the case.
+ *
+ * Each thread records into its own counters, so recording takes no lock
+ * and shares no cache lines; the counters of a thread that exits are folded
+ * into a common total. snapshot() sums the counters of every thread, and
+ * reset() zeroes them. Both may be called at any time from any thread; a
+ * snapshot taken while operations are running is not an instantaneous one,
+ * but every recorded operation appears in it at most once.
+ *
+ * toPrometheus formats a snapshot in the Prometheus text exposition format:
+ * a counter hugeint_operations_total, and histograms hugeint_operation_seconds
+ * and hugeint_operand_limbs, each labelled by operation, e.g.
+ *
+ *   hugeint_operations_total{operation="multiply"} 1024
+ *   hugeint_operation_seconds_bucket{operation="multiply",le="0.000001024"} 998
+ */
+
+#ifndef HUGEINTMETRICS_H
+#define HUGEINTMETRICS_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace iota {
+
+class HugeIntMetrics {
+public:
+    enum Operation {
+        add,
+        subtract,
+        multiply,
+        divide,
+        modulo,
+        exactDivide,
+        parse,
+        print,
+        numOperations
+    };
+
+    // histogram buckets: operand sizes <= 1, 2, 4, ..., 512 limbs, and
+    // latencies <= 16, 32, 64, ..., 2^27 ns, with a last bucket for larger
+    static const int limbBuckets{11};
+    static const int latencyBuckets{25};
+
+    struct Counts {
+        std::uint64_t count{0};
+        std::uint64_t nanoseconds{0};
+        std::uint64_t totalLimbs{0};
+        std::uint64_t limbs[limbBuckets]{};
+        std::uint64_t latency[latencyBuckets]{};
+    };
+
+    using Snapshot = std::array<Counts, numOperations>;
+
+    static void        record(Operation, int, std::uint64_t); // limbs, ns
+    static Snapshot    snapshot();
+    static void        reset();
+    static std::string toPrometheus(const Snapshot&);
+
+    // informational
+    static bool        enabled();
+    static const char* name(Operation);
+};
+
+} /* namespace iota */
+
+#endif /* HUGEINTMETRICS_H */
@@ -0,0 +1,37 @@
+/*
+ * HugeIntTuning.h
+ *
+ * Algorithm thresholds of the HugeInt library, generated by the tuning
+ * program tune/HugeIntTune.cpp. The crossovers between algorithms depend on
+ * the machine, so to tune for one, build and run the tuner on it and
+ * rebuild the library with its output in place of this file:
+ *
+ *   tune/hugeint-tune > HugeIntTuning.h
+ *
+ * The values selected here at compile time are the initial values of the
+ * run-time settings HugeInt::setKaratsubaCutoff and
+ * HugeIntAccumulator::setProductCutoff.
+ */
+
+#ifndef HUGEINTTUNING_H
+#define HUGEINTTUNING_H
+
+#include <cstddef>
+
+namespace iota {
+namespace tuning {
+
+// no. digits of both factors from which operator* uses Karatsuba's method
+const int karatsubaCutoff{32};
+
+// no. digits of both factors from which HugeIntAccumulator::addmul forms
+// the product by operator*
+const int productCutoff{24};
+
+// no. rows from which det uses det_multimodular
+const std::size_t modularCutoff{6};
+
+} /* namespace tuning */
+} /* namespace iota */
+
+#endif /* HUGEINTTUNING_H */
@@ -0,0 +1,331 @@
+/*
+ * Montgomery.cpp
+ *
+ * Implementation of the Montgomery class. See comments in Montgomery.h for
+ * details.
+ *
+ */
+
+#include "Montgomery.h"
+#include <stdexcept>
+
+
+/*
+ * Non-member utility functions (in anonymous namespace -- file scope only).
+ *
+ */
+
+namespace { /* anonymous namespace */
+
+/*
+ * Return true if the n-digit number (a_(n-1) ... a_0) is >= (b_(n-1) ... b_0).
+ *
+ */
+
+inline bool digits_greater_equal(const std::uint32_t* a, const std::uint32_t* b,
+                                 int n) {
+    int i{n - 1};
+    for ( ; i >= 0 && a[i] == b[i]; --i);
+
+    return i < 0 || a[i] > b[i];
+}
+
+/*
+ * Subtract the n-digit number b from a in place, where a >= b (or a has an
+ * implicit extra leading digit absorbing the final borrow).
+ *
+ */
+
+inline void digits_subtract(std::uint32_t* a, const std::uint32_t* b, int n) {
+    std::int64_t borrow{0};
+    for (int i = 0; i < n; ++i) {
+        std::int64_t widedigit = static_cast<std::int64_t>(a[i]) - b[i] + borrow;
+        a[i] = static_cast<std::uint32_t>(widedigit);
+        borrow = widedigit >> 32;
+    }
+}
+
+} /* anonymous namespace */
+
+
+
+namespace iota {
+
+/**
+ * Constructor
+ *
+ * Set up a Montgomery context for the odd modulus m > 1. Computes
+ * -m^(-1) mod 2^32 by Newton iteration (each step doubles the number of
+ * correct low-order bits, and m * m = 1 mod 8 supplies the first three), and
+ * R mod m and R^2 mod m by repeated modular doubling, so no division is
+ * needed.
+ *
+ * @param modulus
+ */
+
+Montgomery::Montgomery(const HugeInt& modulus) : modulus_{modulus} {
+    if (modulus_.isNegative() || (modulus_.digits_[0] & 1) == 0 ||
+        modulus_ == 1LL) {
+        throw std::invalid_argument{"Montgomery modulus must be odd and > 1."};
+    }
+
+    size_ = HugeInt::numDigits_;
+    for ( ; size_ > 0 && modulus_.digits_[size_ - 1] == 0; --size_);
+
+    std::uint32_t inverse{modulus_.digits_[0]};
+    for (int i = 0; i < 4; ++i) {
+        inverse *= 2 - modulus_.digits_[0] * inverse;
+    }
+    mInverse_ = -inverse;
+
+    // R mod m = 2^(32n) mod m, then R^2 mod m = 2^(32n) R mod m.
+    one_ = 1LL;
+    for (int i = 0; i < 32 * size_; ++i) {
+        doubleModulo(one_);
+    }
+
+    rSquared_ = one_;
+    for (int i = 0; i < 32 * size_; ++i) {
+        doubleModulo(rSquared_);
+    }
+}
+
+/**
+ * getModulus()
+ *
+ * @return
+ */
+
+const HugeInt& Montgomery::getModulus() const {
+    return modulus_;
+}
+
+/**
+ * one()
+ *
+ * Return the multiplicative identity in Montgomery form, R mod m.
+ *
+ * @return
+ */
+
+const HugeInt& Montgomery::one() const {
+    return one_;
+}
+
+/**
+ * toMontgomery
+ *
+ * Return xR mod m. The argument x may be any HugeInt; values outside the
+ * range 0 <= x < m are first reduced (with a non-negative result).
+ *
+ * @param x
+ * @return
+ */
+
+HugeInt Montgomery::toMontgomery(const HugeInt& x) const {
+    HugeInt residue{x};
+
+    if (residue.isNegative() || residue >= modulus_) {
+        residue %= modulus_;
+        if (residue.isNegative()) {
+            residue += modulus_;
+        }
+    }
+
+    return multiply(residue, rSquared_);
+}
+
+/**
+ * fromMontgomery
+ *
+ * Return the ordinary residue x, 0 <= x < m, for xR mod m.
+ *
+ * @param x
+ * @return
+ */
+
+HugeInt Montgomery::fromMontgomery(const HugeInt& x) const {
+    return multiply(x, 1LL);
+}
+
+/**
+ * add
+ *
+ * Return a + b mod m, for 0 <= a, b < m.
+ *
+ * @param a
+ * @param b
+ * @return
+ */
+
+HugeInt Montgomery::add(const HugeInt& a, const HugeInt& b) const {
+    HugeInt       sum;
+    std::uint64_t partial{0};
+
+    for (int i = 0; i < size_; ++i) {
+        partial += static_cast<std::uint64_t>(a.digits_[i]) + b.digits_[i];
+        sum.digits_[i] = static_cast<std::uint32_t>(partial);
+        partial >>= 32;
+    }
+
+    // a + b < 2m; the carry out, if any, is absorbed by subtracting m.
+    if (partial != 0 || 
+        digits_greater_equal(sum.digits_, modulus_.digits_, size_)) {
+        digits_subtract(sum.digits_, modulus_.digits_, size_);
+    }
+
+    return sum;
+}
+
+/**
+ * subtract
+ *
+ * Return a - b mod m, for 0 <= a, b < m.
+ *
+ * @param a
+ * @param b
+ * @return
+ */
+
+HugeInt Montgomery::subtract(const HugeInt& a, const HugeInt& b) const {
+    HugeInt difference{a - b};
+
+    if (difference.isNegative()) {
+        difference += modulus_;
+    }
+
+    return difference;
+}
+
+/**
+ * multiply
+ *
+ * Return the Montgomery product a b R^(-1) mod m, for 0 <= a, b < m, using
+ * the coarsely integrated operand scanning (CIOS) method: for each digit
+ * a_i, accumulate a_i * b, then add the multiple u * m (u = t_0 * (-m^(-1))
+ * mod 2^32) that clears the lowest digit, and shift down one digit. The
+ * accumulator never exceeds n + 2 digits and the result is < 2m before the
+ * final conditional subtraction.
+ *
+ * @param a
+ * @param b
+ * @return
+ */
+
+HugeInt Montgomery::multiply(const HugeInt& a, const HugeInt& b) const {
+    const int      n{size_};
+    const std::uint32_t* const m{modulus_.digits_};
+    std::uint32_t  t[HugeInt::numDigits_ + 2]{0};
+
+    for (int i = 0; i < n; ++i) {
+        std::uint64_t carry{0};
+        const std::uint64_t ai{a.digits_[i]};
+
+        for (int j = 0; j < n; ++j) {
+            carry += t[j] + ai * b.digits_[j];
+            t[j] = static_cast<std::uint32_t>(carry);
+            carry >>= 32;
+        }
+        carry += t[n];
+        t[n] = static_cast<std::uint32_t>(carry);
+        t[n + 1] = static_cast<std::uint32_t>(carry >> 32);
+
+        const std::uint64_t u{static_cast<std::uint32_t>(t[0] * mInverse_)};
+
+        carry = (t[0] + u * m[0]) >> 32;
+        for (int j = 1; j < n; ++j) {
+            carry += t[j] + u * m[j];
+            t[j - 1] = static_cast<std::uint32_t>(carry);
+            carry >>= 32;
+        }
+        carry += t[n];
+        t[n - 1] = static_cast<std::uint32_t>(carry);
+        t[n] = t[n + 1] + static_cast<std::uint32_t>(carry >> 32);
+    }
+
+    // Conditional final subtraction: t < 2m, and t >= m if t_n != 0.
+    HugeInt result;
+
+    for (int i = 0; i < n; ++i) {
+        result.digits_[i] = t[i];
+    }
+
+    if (t[n] != 0 || digits_greater_equal(t, m, n)) {
+        digits_subtract(result.digits_, m, n);
+    }
+
+    return result;
+}
+
+/**
+ * square
+ *
+ * Return a^2 R^(-1) mod m.
+ *
+ * @param a
+ * @return
+ */
+
+HugeInt Montgomery::square(const HugeInt& a) const {
+    return multiply(a, a);
+}
+
+/**
+ * power
+ *
+ * Return x^e in Montgomery form, where x is in Montgomery form and the
+ * exponent e >= 0 is an ordinary HugeInt. Uses fixed 4-bit windows,
+ * scanning the exponent from its most significant bit: one multiplication
+ * per window after four squarings.
+ *
+ * @param x
+ * @param exponent
+ * @return
+ */
+
+HugeInt Montgomery::power(const HugeInt& x, const HugeInt& exponent) const {
+    if (exponent.isNegative()) {
+        throw std::invalid_argument{"negative exponent in Montgomery power."};
+    }
+
+    HugeInt table[16];
+    table[0] = one_;
+    for (int i = 1; i < 16; ++i) {
+        table[i] = multiply(table[i - 1], x);
+    }
+
+    const int windows{(exponent.bitLength() + 3) / 4};
+    HugeInt   result{one_};
+
+    for (int w = windows - 1; w >= 0; --w) {
+        if (w != windows - 1) {
+            for (int s = 0; s < 4; ++s) {
+                result = square(result);
+            }
+        }
+
+        const std::uint32_t nibble{
+            (exponent.digits_[w / 8] >> (4 * (w % 8))) & 0xf};
+        if (nibble != 0) {
+            result = multiply(result, table[nibble]);
+        }
+    }
+
+    return result;
+}
+
+/**
+ * doubleModulo: (private utility function)
+ *
+ * Replace x (0 <= x < m) by 2x mod m, in place.
+ *
+ * @param x
+ * @return
+ */
+
+HugeInt& Montgomery::doubleModulo(HugeInt& x) const {
+    x = add(x, x);
+    return x;
+}
+
+} /* namespace iota */
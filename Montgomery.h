@@ -0,0 +1,57 @@
+/*
+ * Montgomery.h
+ *
+ * Montgomery modular arithmetic for a fixed odd modulus m > 1.
+ *
+ * With n the number of significant base 2^32 digits of m and R = (2^32)^n,
+ * a residue x (0 <= x < m) is held in Montgomery form as xR mod m. The
+ * product of two residues in this form is obtained with a single
+ * interleaved multiply-and-reduce pass over n digits (the CIOS method),
+ * without any division by m. Only the conversions into and out of
+ * Montgomery form, and the setup of the context, cost more than this.
+ *
+ * All operands and results of add, subtract, multiply, square and power are
+ * residues in Montgomery form; exponents are ordinary non-negative HugeInts.
+ */
+
+#ifndef MONTGOMERY_H
+#define MONTGOMERY_H
+
+#include "HugeInt.h"
+#include <cstdint>
+
+namespace iota {
+
+class Montgomery {
+public:
+    explicit Montgomery(const HugeInt&); // odd modulus m > 1
+
+    // informational
+    const HugeInt& getModulus() const;
+    const HugeInt& one() const;          // 1 in Montgomery form, R mod m
+
+    // conversion to and from Montgomery form
+    HugeInt toMontgomery(const HugeInt&) const;
+    HugeInt fromMontgomery(const HugeInt&) const;
+
+    // modular arithmetic on residues in Montgomery form
+    HugeInt add(const HugeInt&, const HugeInt&) const;
+    HugeInt subtract(const HugeInt&, const HugeInt&) const;
+    HugeInt multiply(const HugeInt&, const HugeInt&) const;
+    HugeInt square(const HugeInt&) const;
+    HugeInt power(const HugeInt&, const HugeInt&) const;
+
+private:
+    HugeInt       modulus_;
+    HugeInt       one_;          // R mod m
+    HugeInt       rSquared_;     // R^2 mod m
+    std::uint32_t mInverse_;     // -m^(-1) mod 2^32
+    int           size_;         // no. significant base 2^32 digits in m
+
+    // private utility functions
+    HugeInt&      doubleModulo(HugeInt&) const;
+};
+
+} /* namespace iota */
+
+#endif /* MONTGOMERY_H */
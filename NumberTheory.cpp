@@ -0,0 +1,1149 @@
+/*
+ * NumberTheory.cpp
+ *
+ * Implementation of the number-theoretic functions declared in
+ * NumberTheory.h.
+ *
+ */
+
+#include "NumberTheory.h"
+#include "Montgomery.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+
+/*
+ * Non-member utility functions (in anonymous namespace -- file scope only).
+ *
+ */
+
+namespace { /* anonymous namespace */
+
+/*
+ * Table of quadratic residues modulo m: isSquare[r] is true if and only if
+ * r = x^2 (mod m) for some x.
+ *
+ */
+
+struct ResidueTable {
+    explicit ResidueTable(std::uint32_t m) : modulus{m}, isSquare(m, false) {
+        for (std::uint32_t x = 0; x < m; ++x) {
+            isSquare[(x * x) % m] = true;
+        }
+    }
+
+    bool test(std::uint32_t r) const {
+        return isSquare[r % modulus];
+    }
+
+    std::uint32_t     modulus;
+    std::vector<bool> isSquare;
+};
+
+const ResidueTable squaresMod64{64};
+const ResidueTable squaresMod63{63};
+const ResidueTable squaresMod65{65};
+const ResidueTable squaresMod11{11};
+
+// 64 * 63 * 65 * 11; a single short modulo gives all four residues.
+const std::uint32_t squareFilterModulus{2882880};
+
+/*
+ * Return x^k for k >= 0 by binary exponentiation. No overflow checking.
+ *
+ */
+
+iota::HugeInt power(iota::HugeInt x, int k) {
+    iota::HugeInt result{1LL};
+
+    while (k > 0) {
+        if (k & 1) {
+            result *= x;
+        }
+        k >>= 1;
+        if (k > 0) {
+            x *= x;
+        }
+    }
+
+    return result;
+}
+
+/*
+ * Set *product = a * b and return true if a * b <= bound; otherwise return
+ * false. Here 0 <= a, b <= bound. Bit lengths decide most cases without
+ * multiplying; otherwise a * b < 2^(bitLength(bound) + 1), which cannot wrap
+ * past the most significant digit, so a product that lands in the negative
+ * range is simply too large.
+ *
+ */
+
+bool bounded_multiply(const iota::HugeInt& a, const iota::HugeInt& b,
+                      const iota::HugeInt& bound, iota::HugeInt* product) {
+    if (a.isZero() || b.isZero()) {
+        *product = 0LL;
+        return true;
+    }
+
+    if (a.bitLength() + b.bitLength() - 2 >= bound.bitLength()) {
+        return false;                 // a * b >= 2^(la + lb - 2) > bound
+    }
+
+    *product = a * b;
+
+    return !product->isNegative() && *product <= bound;
+}
+
+/*
+ * Set *result = x^k and return true if x^k <= bound (x >= 0, k >= 0);
+ * otherwise return false. Used by the Newton iteration of iroot, where x^k 
+ * for an over-estimate of the root may not be representable at all.
+ *
+ */
+
+bool bounded_power(const iota::HugeInt& x, int k, const iota::HugeInt& bound,
+                   iota::HugeInt* result) {
+    int topBit{0};
+    while ((k >> topBit) > 1) {
+        ++topBit;
+    }
+
+    *result = 1LL;
+    for (int i = topBit; i >= 0 && k > 0; --i) {
+        if (!bounded_multiply(*result, *result, bound, result)) {
+            return false;
+        }
+        if (((k >> i) & 1) && !bounded_multiply(*result, x, bound, result)) {
+            return false;
+        }
+    }
+
+    return *result <= bound;
+}
+
+/*
+ * Return the 2-adic valuation of x > 0, i.e., the largest v with 2^v | x.
+ *
+ */
+
+int trailing_zero_bits(const iota::HugeInt& x) {
+    iota::HugeInt copy{x};
+    int           v{0};
+
+    while (copy.shortModulo(1U << 31) == 0) {
+        copy.shiftRightBits(31);
+        v += 31;
+    }
+
+    for (std::uint32_t low = copy.shortModulo(1U << 31); (low & 1) == 0;
+         low >>= 1) {
+        ++v;
+    }
+
+    return v;
+}
+
+/*
+ * Return an initial estimate x0 >= floor(n^(1/k)) for the Newton iteration
+ * in iroot, seeded from the (at most) 64 leading bits of n in floating point.
+ * The estimate exceeds the true root by a relative error of about 2^-30, so
+ * only a couple of Newton steps are required.
+ *
+ */
+
+iota::HugeInt root_estimate(const iota::HugeInt& n, int k) {
+    const int     bits{n.bitLength()};
+    const int     shift{bits > 64 ? bits - 64 : 0};
+    iota::HugeInt top{n};
+
+    top.shiftRightBits(shift);
+
+    const long double log2n{std::log2(static_cast<long double>(top)) + shift};
+    const long double e{log2n / k};
+    const int         rootShift{e > 60.0L ? static_cast<int>(e) - 60 : 0};
+    const long double mantissa{std::exp2(e - rootShift)
+                                   * (1.0L + std::exp2(-30.0L))};
+
+    iota::HugeInt estimate{static_cast<long long>(mantissa) + 2};
+
+    return estimate.shiftLeftBits(rootShift);
+}
+
+/*
+ * Return the primes below 10000, computed once with a sieve of Eratosthenes.
+ * Used for trial division and as Miller-Rabin bases.
+ *
+ */
+
+const std::vector<std::uint32_t>& small_primes() {
+    static const std::vector<std::uint32_t> primes = [] {
+        const std::uint32_t     limit{10000};
+        std::vector<bool>       composite(limit, false);
+        std::vector<std::uint32_t> result;
+
+        for (std::uint32_t p = 2; p < limit; ++p) {
+            if (!composite[p]) {
+                result.push_back(p);
+                for (std::uint32_t q = p * p; q < limit; q += p) {
+                    composite[q] = true;
+                }
+            }
+        }
+
+        return result;
+    }();
+
+    return primes;
+}
+
+/*
+ * Digit-vector helpers for the binary Jacobi algorithm. The vectors hold the
+ * significant base 2^32 digits of a non-negative value, least significant
+ * first, with no leading zero digits (so zero is the empty vector).
+ *
+ */
+
+void trim_digits(std::vector<std::uint32_t>& u) {
+    while (!u.empty() && u.back() == 0) {
+        u.pop_back();
+    }
+}
+
+int compare_digits(const std::vector<std::uint32_t>& u,
+                   const std::vector<std::uint32_t>& v) {
+    if (u.size() != v.size()) {
+        return u.size() < v.size() ? -1 : 1;
+    }
+
+    for (std::size_t i = u.size(); i > 0; --i) {
+        if (u[i - 1] != v[i - 1]) {
+            return u[i - 1] < v[i - 1] ? -1 : 1;
+        }
+    }
+
+    return 0;
+}
+
+// u -= v, where u >= v.
+void subtract_digits(std::vector<std::uint32_t>& u,
+                     const std::vector<std::uint32_t>& v) {
+    std::int64_t borrow{0};
+    for (std::size_t i = 0; i < u.size(); ++i) {
+        std::int64_t widedigit = static_cast<std::int64_t>(u[i]) + borrow
+                               - (i < v.size() ? v[i] : 0);
+        u[i] = static_cast<std::uint32_t>(widedigit);
+        borrow = widedigit >> 32;
+    }
+
+    trim_digits(u);
+}
+
+// Divide u > 0 by the largest power of two dividing it; return the exponent.
+int strip_twos(std::vector<std::uint32_t>& u) {
+    std::size_t whole{0};
+    while (u[whole] == 0) {
+        ++whole;
+    }
+
+    int bits{0};
+    while (((u[whole] >> bits) & 1) == 0) {
+        ++bits;
+    }
+
+    u.erase(u.begin(), u.begin() + whole);
+
+    if (bits != 0) {
+        for (std::size_t i = 0; i + 1 < u.size(); ++i) {
+            u[i] = (u[i] >> bits) | (u[i + 1] << (32 - bits));
+        }
+        u.back() >>= bits;
+        trim_digits(u);
+    }
+
+    return 32 * static_cast<int>(whole) + bits;
+}
+
+/*
+ * Return a non-trivial factor of the odd composite n (which is not a prime
+ * power of a small prime), using Brent's variant of Pollard's rho method with
+ * the iteration x <- x^2 + c carried out in Montgomery form. The products of
+ * the differences |x - y| are accumulated over batches of 128 steps so that
+ * only one gcd is needed per batch; if a batch overshoots to the trivial
+ * factor n, the last batch is replayed one step at a time. A fresh c is
+ * tried if the cycle closes without a proper factor.
+ *
+ */
+
+iota::HugeInt pollard_brent(const iota::HugeInt& n) {
+    const iota::Montgomery mont{n};
+    const int              batch{128};
+
+    for (long long c = 1; ; ++c) {
+        const iota::HugeInt cm{mont.toMontgomery(c)};
+        auto f = [&](const iota::HugeInt& x) {
+            return mont.add(mont.square(x), cm);
+        };
+
+        iota::HugeInt y{mont.toMontgomery(2LL)};
+        iota::HugeInt x;
+        iota::HugeInt ys;
+        iota::HugeInt q{mont.one()};
+        iota::HugeInt g{1LL};
+
+        for (long long r = 1; g == 1LL; r *= 2) {
+            x = y;
+            for (long long i = 0; i < r; ++i) {
+                y = f(y);
+            }
+
+            for (long long k = 0; k < r && g == 1LL; k += batch) {
+                ys = y;
+                for (long long i = 0; i < std::min<long long>(batch, r - k);
+                     ++i) {
+                    y = f(y);
+                    q = mont.multiply(q, mont.subtract(x, y));
+                }
+                g = iota::gcd(q, n);
+            }
+        }
+
+        if (g == n) {
+            do {
+                ys = f(ys);
+                g = iota::gcd(mont.subtract(x, ys), n);
+            } while (g == 1LL);
+        }
+
+        if (g != n) {
+            return g;
+        }
+    }
+}
+
+/*
+ * Return the modular square root of the quadratic residue x (in Montgomery
+ * form) modulo the prime p, where p - 1 = q 2^s with q odd, by the
+ * Tonelli-Shanks algorithm. Costs two exponentiations plus O(s^2)
+ * multiplications.
+ *
+ */
+
+iota::HugeInt tonelli_shanks(const iota::Montgomery& mont, const iota::HugeInt& x,
+                             const iota::HugeInt& q, int s) {
+    const iota::HugeInt& p{mont.getModulus()};
+
+    // any quadratic non-residue z generates the 2-Sylow subgroup via z^q
+    long long z{2};
+    while (iota::jacobi(z, p) != -1) {
+        ++z;
+    }
+
+    int           m{s};
+    iota::HugeInt c{mont.power(mont.toMontgomery(z), q)};
+    iota::HugeInt t{mont.power(x, q)};
+    iota::HugeInt root{mont.power(x, (q + 1LL).shiftRightBits(1))};
+
+    while (t != mont.one()) {
+        int           i{0};
+        iota::HugeInt t2i{t};
+        while (t2i != mont.one()) {
+            t2i = mont.square(t2i);
+            ++i;
+        }
+
+        iota::HugeInt b{c};
+        for (int j = 0; j < m - i - 1; ++j) {
+            b = mont.square(b);
+        }
+
+        m = i;
+        c = mont.square(b);
+        t = mont.multiply(t, c);
+        root = mont.multiply(root, b);
+    }
+
+    return root;
+}
+
+/*
+ * Return the modular square root of the quadratic residue x (in Montgomery
+ * form) modulo the prime p by Cipolla's algorithm: with b chosen such that
+ * w = b^2 - x is a non-residue, (b + sqrt(w))^((p+1)/2) computed in
+ * F_p[sqrt(w)] lies in F_p and is a root. Costs one exponentiation in the
+ * extension field, independent of the power of two dividing p - 1.
+ *
+ */
+
+iota::HugeInt cipolla(const iota::Montgomery& mont, const iota::HugeInt& x) {
+    const iota::HugeInt& p{mont.getModulus()};
+
+    long long     b{1};
+    iota::HugeInt bm;
+    iota::HugeInt w;
+
+    for ( ; ; ++b) {
+        bm = mont.toMontgomery(b);
+        w = mont.subtract(mont.square(bm), x);
+        if (iota::jacobi(mont.fromMontgomery(w), p) == -1) {
+            break;
+        }
+    }
+
+    // (u1 + v1 r)(u2 + v2 r) = (u1 u2 + v1 v2 w) + (u1 v2 + u2 v1) r, r^2 = w
+    iota::HugeInt u{mont.one()};
+    iota::HugeInt v;
+    const iota::HugeInt exponent{(p + 1LL).shiftRightBits(1)};
+
+    for (int i = exponent.bitLength() - 1; i >= 0; --i) {
+        const iota::HugeInt uu{mont.square(u)};
+        const iota::HugeInt vv{mont.square(v)};
+        const iota::HugeInt uv{mont.multiply(u, v)};
+
+        u = mont.add(uu, mont.multiply(vv, w));
+        v = mont.add(uv, uv);
+
+        iota::HugeInt bit{exponent};
+        if (bit.shiftRightBits(i).shortModulo(2) == 1) {
+            const iota::HugeInt uNew{mont.add(mont.multiply(u, bm),
+                                              mont.multiply(v, w))};
+            v = mont.add(u, mont.multiply(v, bm));
+            u = uNew;
+        }
+    }
+
+    return u;
+}
+
+} /* anonymous namespace */
+
+
+
+namespace iota {
+
+/**
+ * isqrt:
+ *
+ * Return the integer square root s = floor(sqrt(n)) of n >= 0. If remainder
+ * is not a nullptr, the remainder r = n - s^2 (0 <= r <= 2s) is returned in
+ * space allocated by the caller.
+ *
+ * The leading 62 or 63 bits of n (an even shift) give a double-word
+ * approximation whose root is computed in floating point and corrected
+ * exactly. Scaled back up, this gives an estimate that is guaranteed to
+ * be >= s, from which Newton's iteration x <- (x + n/x)/2 decreases
+ * monotonically to s, doubling the number of correct bits per step.
+ *
+ * @param n
+ * @param remainder
+ * @return
+ */
+
+HugeInt isqrt(const HugeInt& n, HugeInt* const remainder) {
+    if (n.isNegative()) {
+        throw std::domain_error{"isqrt of a negative HugeInt."};
+    }
+
+    const int bits{n.bitLength()};
+    const int shift{bits > 62 ? (bits - 61) & ~1 : 0};
+    HugeInt   top{n};
+
+    top.shiftRightBits(shift);
+
+    // top < 2^63 is exactly representable in a long double
+    const std::uint64_t t{
+        static_cast<std::uint64_t>(static_cast<long double>(top))};
+    std::uint64_t r{static_cast<std::uint64_t>(
+                        std::sqrt(static_cast<long double>(t)))};
+
+    while (r * r > t) {
+        --r;
+    }
+    while ((r + 1) * (r + 1) <= t) {
+        ++r;
+    }
+
+    HugeInt root{static_cast<long long>(r)};
+
+    if (shift != 0) {
+        // n < (t + 1) 2^shift <= (r + 1)^2 2^shift, so x >= sqrt(n).
+        HugeInt x{static_cast<long long>(r + 1)};
+        x.shiftLeftBits(shift / 2);
+
+        for (;;) {
+            HugeInt y{x + n / x};
+            y.shiftRightBits(1);
+
+            if (y >= x) {
+                break;
+            }
+            x = y;
+        }
+
+        root = x;
+    }
+
+    if (remainder != nullptr) {
+        *remainder = n - root * root;
+    }
+
+    return root;
+}
+
+/**
+ * iroot:
+ *
+ * Return the integer k'th root s of n, truncated towards zero, for k >= 1.
+ * Negative n is permitted when k is odd, in which case s = -iroot(-n, k).
+ * If remainder is not a nullptr, r = n - s^k is returned in space allocated
+ * by the caller.
+ *
+ * For n > 0, Newton's iteration x <- ((k - 1) x + n / x^(k-1)) / k is
+ * started from a floating point estimate slightly above the root (see
+ * root_estimate) and decreases monotonically to floor(n^(1/k)).
+ *
+ * @param n
+ * @param k
+ * @param remainder
+ * @return
+ */
+
+HugeInt iroot(const HugeInt& n, int k, HugeInt* const remainder) {
+    if (k < 1) {
+        throw std::domain_error{"iroot of non-positive degree."};
+    }
+
+    if (n.isNegative()) {
+        if (k % 2 == 0) {
+            throw std::domain_error{"even iroot of a negative HugeInt."};
+        }
+
+        HugeInt root{-iroot(-n, k, remainder)};
+        if (remainder != nullptr) {
+            *remainder = -*remainder;
+        }
+
+        return root;
+    }
+
+    if (k == 2) {
+        return isqrt(n, remainder);
+    }
+
+    HugeInt root;
+
+    if (k == 1 || n.bitLength() <= 1) {
+        root = n;                           // n^(1/1) = n; 0 and 1 are fixed
+    }
+    else if (n.bitLength() <= k) {
+        root = 1LL;                         // 1 <= n < 2^k
+    }
+    else {
+        HugeInt x{root_estimate(n, k)};
+        HugeInt xpow;
+
+        for (;;) {
+            // If x^(k-1) > n, the quotient n / x^(k-1) vanishes.
+            HugeInt y{x * (k - 1LL)};
+            if (bounded_power(x, k - 1, n, &xpow)) {
+                y += n / xpow;
+            }
+            y /= k;
+
+            if (y >= x) {
+                break;
+            }
+            x = y;
+        }
+
+        // Guard against an estimate that fell below the root.
+        while (bounded_power(x + 1LL, k, n, &xpow)) {
+            ++x;
+        }
+
+        root = x;
+    }
+
+    if (remainder != nullptr) {
+        *remainder = n - power(root, k);
+    }
+
+    return root;
+}
+
+/**
+ * is_perfect_square:
+ *
+ * Return true if n = s^2 for some integer s. About 99.4% of non-squares are
+ * rejected by testing the residues of n modulo 64, 63, 65 and 11 (obtained
+ * from a single short modulo) before any square root is computed.
+ *
+ * @param n
+ * @return
+ */
+
+bool is_perfect_square(const HugeInt& n) {
+    if (n.isNegative()) {
+        return false;
+    }
+
+    const std::uint32_t r{n.shortModulo(squareFilterModulus)};
+
+    if (!squaresMod64.test(r) || !squaresMod63.test(r) ||
+        !squaresMod65.test(r) || !squaresMod11.test(r)) {
+        return false;
+    }
+
+    HugeInt remainder;
+    isqrt(n, &remainder);
+
+    return remainder.isZero();
+}
+
+/**
+ * is_perfect_power:
+ *
+ * Return true if n = s^k for some integers s and k >= 2. By convention 0, 1
+ * and -1 are perfect powers. A negative n is a perfect power only if -n is
+ * a perfect odd power.
+ *
+ * It suffices to try prime exponents p. Since 2^p <= |n| the candidates are
+ * bounded by the bit length of n, and if 2^v exactly divides n (v > 0), then
+ * p must also divide v, which eliminates most exponents outright.
+ *
+ * @param n
+ * @return
+ */
+
+bool is_perfect_power(const HugeInt& n) {
+    const bool    negative{n.isNegative()};
+    const HugeInt m{negative ? -n : n};
+
+    if (m.bitLength() <= 1) {
+        return true;
+    }
+
+    const int bits{m.bitLength()};
+    const int v{trailing_zero_bits(m)};
+
+    // Sieve of Eratosthenes for the prime exponents 2 <= p <= bits.
+    std::vector<bool> composite(bits + 1, false);
+
+    for (int p = 2; p <= bits; ++p) {
+        if (composite[p]) {
+            continue;
+        }
+        for (int q = 2 * p; q <= bits; q += p) {
+            composite[q] = true;
+        }
+
+        if ((negative && p == 2) || (v > 0 && v % p != 0)) {
+            continue;
+        }
+
+        if (p == 2) {
+            if (is_perfect_square(m)) {
+                return true;
+            }
+            continue;
+        }
+
+        HugeInt remainder;
+        iroot(m, p, &remainder);
+
+        if (remainder.isZero()) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * gcd:
+ *
+ * Return the (non-negative) greatest common divisor of a and b, by Euclid's
+ * algorithm. gcd(0, 0) = 0.
+ *
+ * @param a
+ * @param b
+ * @return
+ */
+
+HugeInt gcd(const HugeInt& a, const HugeInt& b) {
+    HugeInt u{a.isNegative() ? -a : a};
+    HugeInt v{b.isNegative() ? -b : b};
+
+    while (!v.isZero()) {
+        HugeInt r{u % v};
+        u = v;
+        v = r;
+    }
+
+    return u;
+}
+
+/**
+ * invmod:
+ *
+ * Return the inverse of a modulo m > 1, i.e., the x with 0 <= x < m and
+ * a x = 1 (mod m), by the extended Euclidean algorithm. Throws
+ * std::domain_error if gcd(a, m) != 1.
+ *
+ * @param a
+ * @param m
+ * @return
+ */
+
+HugeInt invmod(const HugeInt& a, const HugeInt& m) {
+    if (m.isNegative() || m < 2LL) {
+        throw std::domain_error{"invmod requires a modulus m > 1."};
+    }
+
+    // invariants: r0 = s0 a (mod m), r1 = s1 a (mod m)
+    HugeInt r0{a % m};
+    if (r0.isNegative()) {
+        r0 += m;
+    }
+    HugeInt r1{m};
+    HugeInt s0{1LL};
+    HugeInt s1{0LL};
+
+    while (!r1.isZero()) {
+        const HugeInt quotient{r0 / r1};
+        const HugeInt remainder{r0 - quotient * r1};
+
+        r0 = r1;
+        r1 = remainder;
+
+        const HugeInt s{s0 - quotient * s1};
+        s0 = s1;
+        s1 = s;
+    }
+
+    if (r0 != 1LL) {
+        throw std::domain_error{"invmod of a non-invertible residue."};
+    }
+
+    return s0.isNegative() ? s0 + m : s0;
+}
+
+/**
+ * crt:
+ *
+ * Chinese remaindering: return the unique x, 0 <= x < M = m_0 m_1 ...,
+ * with x = r_i (mod m_i) for each i, where the moduli m_i > 1 are pairwise
+ * coprime. The residues are combined incrementally (Garner's method), so
+ * each step needs one modular inverse modulo a single m_i.
+ *
+ * @param residues
+ * @param moduli
+ * @return
+ */
+
+HugeInt crt(const std::vector<HugeInt>& residues,
+            const std::vector<HugeInt>& moduli) {
+    if (residues.size() != moduli.size()) {
+        throw std::invalid_argument{"crt needs one residue per modulus."};
+    }
+
+    HugeInt x{0LL};
+    HugeInt product{1LL};
+
+    for (std::size_t i = 0; i < moduli.size(); ++i) {
+        const HugeInt& m{moduli[i]};
+
+        // x + product t = r_i (mod m)  =>  t = (r_i - x) / product (mod m)
+        HugeInt t{(residues[i] - x) % m * invmod(product, m) % m};
+        if (t.isNegative()) {
+            t += m;
+        }
+
+        x += product * t;
+        product *= m;
+    }
+
+    return x;
+}
+
+/**
+ * powmod:
+ *
+ * Return a^e mod m, with 0 <= result < m, for e >= 0 and m > 0. An odd
+ * modulus uses Montgomery multiplication; an even modulus falls back to
+ * binary exponentiation with operator%, and requires m^2 to be
+ * representable as a HugeInt.
+ *
+ * @param a
+ * @param e
+ * @param m
+ * @return
+ */
+
+HugeInt powmod(const HugeInt& a, const HugeInt& e, const HugeInt& m) {
+    if (m.isNegative() || m.isZero() || e.isNegative()) {
+        throw std::domain_error{"powmod requires e >= 0 and m > 0."};
+    }
+
+    if (m == 1LL) {
+        return 0LL;
+    }
+
+    if (m.shortModulo(2) == 1) {
+        const Montgomery mont{m};
+        return mont.fromMontgomery(mont.power(mont.toMontgomery(a), e));
+    }
+
+    HugeInt base{a % m};
+    if (base.isNegative()) {
+        base += m;
+    }
+
+    HugeInt result{1LL};
+    for (int i = e.bitLength() - 1; i >= 0; --i) {
+        result = result * result % m;
+
+        HugeInt bit{e};
+        if (bit.shiftRightBits(i).shortModulo(2) == 1) {
+            result = result * base % m;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * is_probable_prime:
+ *
+ * Return true if n is prime, or a strong probable prime to the first
+ * `rounds' prime bases (Miller-Rabin test). Values below 10^8 are decided
+ * exactly by trial division; for n < 3.3 * 10^24 the default of 25 bases is
+ * also a proof of primality. Composites are always rejected with probability
+ * at least 1 - 4^(-rounds).
+ *
+ * @param n
+ * @param rounds
+ * @return
+ */
+
+bool is_probable_prime(const HugeInt& n, int rounds) {
+    if (n.isNegative() || n < 2LL) {
+        return false;
+    }
+
+    const std::vector<std::uint32_t>& primes{small_primes()};
+
+    for (std::uint32_t p : primes) {
+        if (n.shortModulo(p) == 0) {
+            return n == static_cast<long long>(p);
+        }
+    }
+
+    if (n < static_cast<long long>(primes.back()) * primes.back()) {
+        return true;
+    }
+
+    // n - 1 = d 2^s, d odd
+    const HugeInt nm1{n - 1LL};
+    const int     s{trailing_zero_bits(nm1)};
+    HugeInt       d{nm1};
+    d.shiftRightBits(s);
+
+    const Montgomery mont{n};
+    const HugeInt    minusOne{mont.toMontgomery(nm1)};
+
+    for (int i = 0; i < rounds && i < static_cast<int>(primes.size()); ++i) {
+        HugeInt x{mont.power(mont.toMontgomery(primes[i]), d)};
+
+        if (x == mont.one() || x == minusOne) {
+            continue;
+        }
+
+        bool witness{true};
+        for (int j = 1; j < s && witness; ++j) {
+            x = mont.square(x);
+            if (x == minusOne) {
+                witness = false;
+            }
+        }
+
+        if (witness) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * factorize:
+ *
+ * Return the prime factorization of n >= 1 as (prime, exponent) pairs in
+ * increasing order of the primes. Factors below 10^4 are removed by trial
+ * division; the remaining cofactor is split with Pollard's rho (Brent's
+ * variant, in Montgomery arithmetic) until every part passes
+ * is_probable_prime. The running time depends on the size of the
+ * second-largest prime factor, so this is intended for numbers such as the
+ * group orders p - 1 used below, not for hard composites.
+ *
+ * @param n
+ * @return
+ */
+
+std::vector<std::pair<HugeInt, int>> factorize(const HugeInt& n) {
+    if (n.isNegative() || n.isZero()) {
+        throw std::domain_error{"factorize requires n >= 1."};
+    }
+
+    std::vector<HugeInt> primeFactors;
+    HugeInt              cofactor{n};
+
+    for (std::uint32_t p : small_primes()) {
+        if (cofactor < static_cast<long long>(p) * p) {
+            break;
+        }
+        while (cofactor.shortModulo(p) == 0) {
+            primeFactors.push_back(static_cast<long long>(p));
+            cofactor /= static_cast<long long>(p);
+        }
+    }
+
+    std::vector<HugeInt> pending;
+    if (cofactor != 1LL) {
+        pending.push_back(cofactor);
+    }
+
+    while (!pending.empty()) {
+        HugeInt m{pending.back()};
+        pending.pop_back();
+
+        if (is_probable_prime(m)) {
+            primeFactors.push_back(m);
+        }
+        else if (is_perfect_square(m)) {
+            const HugeInt root{isqrt(m)};
+            pending.push_back(root);
+            pending.push_back(root);
+        }
+        else {
+            const HugeInt d{pollard_brent(m)};
+            pending.push_back(d);
+            pending.push_back(divexact(m, d));
+        }
+    }
+
+    std::sort(primeFactors.begin(), primeFactors.end());
+
+    std::vector<std::pair<HugeInt, int>> result;
+    for (const HugeInt& p : primeFactors) {
+        if (!result.empty() && result.back().first == p) {
+            ++result.back().second;
+        }
+        else {
+            result.emplace_back(p, 1);
+        }
+    }
+
+    return result;
+}
+
+/**
+ * jacobi:
+ *
+ * Return the Jacobi symbol (a/n), one of -1, 0 or +1, for odd n > 0 and any
+ * a. Uses the binary algorithm on the base 2^32 digits: factors of two are
+ * stripped with (2/n) = (-1)^((n^2-1)/8), the larger operand is reduced by
+ * subtraction, and quadratic reciprocity is applied on every swap. Only
+ * shifts and subtractions are used -- no divisions.
+ *
+ * @param a
+ * @param n
+ * @return
+ */
+
+int jacobi(const HugeInt& a, const HugeInt& n) {
+    if (n.isNegative() || (n.digits_[0] & 1) == 0) {
+        throw std::domain_error{"jacobi requires an odd, positive n."};
+    }
+
+    int     result{1};
+    HugeInt x{a};
+
+    // (-1/n) = (-1)^((n-1)/2)
+    if (x.isNegative()) {
+        x.radixComplement();
+        if ((n.digits_[0] & 3) == 3) {
+            result = -result;
+        }
+    }
+
+    std::vector<std::uint32_t> u(x.digits_, x.digits_ + HugeInt::numDigits_);
+    std::vector<std::uint32_t> v(n.digits_, n.digits_ + HugeInt::numDigits_);
+    trim_digits(u);
+    trim_digits(v);
+
+    while (!u.empty()) {
+        const std::uint32_t n8{v[0] & 7};
+        if ((strip_twos(u) & 1) && (n8 == 3 || n8 == 5)) {
+            result = -result;
+        }
+
+        if (compare_digits(u, v) < 0) {
+            u.swap(v);
+            if ((u[0] & 3) == 3 && (v[0] & 3) == 3) {
+                result = -result;
+            }
+        }
+
+        subtract_digits(u, v);
+    }
+
+    return (v.size() == 1 && v[0] == 1) ? result : 0;
+}
+
+/**
+ * sqrtmod:
+ *
+ * Return a square root r of a modulo the odd prime p (or p = 2), i.e.,
+ * r^2 = a (mod p), choosing the smaller of the two roots r and p - r. Throws
+ * std::domain_error if a is a quadratic non-residue.
+ *
+ * For p = 3 (mod 4), r = a^((p+1)/4). Otherwise, with p - 1 = q 2^s, the
+ * Tonelli-Shanks algorithm is used while its O(s^2) tail is cheap, and
+ * Cipolla's algorithm (whose cost does not depend on s) when s is large.
+ *
+ * @param a
+ * @param p
+ * @return
+ */
+
+HugeInt sqrtmod(const HugeInt& a, const HugeInt& p) {
+    if (p == 2LL) {
+        return a.isNegative() ? (-a).shortModulo(2) : a.shortModulo(2);
+    }
+
+    HugeInt residue{a % p};
+    if (residue.isNegative()) {
+        residue += p;
+    }
+
+    if (residue.isZero()) {
+        return residue;
+    }
+
+    if (jacobi(residue, p) != 1) {
+        throw std::domain_error{"sqrtmod of a quadratic non-residue."};
+    }
+
+    const Montgomery mont{p};
+    const HugeInt    x{mont.toMontgomery(residue)};
+    HugeInt          root;
+
+    if (p.shortModulo(4) == 3) {
+        root = mont.power(x, (p + 1LL).shiftRightBits(2));
+    }
+    else {
+        const HugeInt pm1{p - 1LL};
+        const int     s{trailing_zero_bits(pm1)};
+        HugeInt       q{pm1};
+        q.shiftRightBits(s);
+
+        if (s * s > 8 * p.bitLength()) {
+            root = cipolla(mont, x);
+        }
+        else {
+            root = tonelli_shanks(mont, x, q, s);
+        }
+    }
+
+    root = mont.fromMontgomery(root);
+
+    const HugeInt other{p - root};
+    return other < root ? other : root;
+}
+
+/**
+ * multiplicative_order:
+ *
+ * Return the multiplicative order of a modulo the prime p, i.e., the least
+ * k > 0 with a^k = 1 (mod p), where a is not divisible by p. Starting from
+ * k = p - 1, each prime factor q of p - 1 is divided out of k for as long as
+ * a^(k/q) = 1 remains true.
+ *
+ * @param a
+ * @param p
+ * @return
+ */
+
+HugeInt multiplicative_order(const HugeInt& a, const HugeInt& p) {
+    HugeInt residue{a % p};
+    if (residue.isZero()) {
+        throw std::domain_error{"multiplicative_order of a multiple of p."};
+    }
+
+    HugeInt order{p - 1LL};
+
+    if (p == 2LL) {
+        return order;
+    }
+
+    const Montgomery mont{p};
+    const HugeInt    x{mont.toMontgomery(residue)};
+
+    for (const auto& factor : factorize(order)) {
+        for (int j = 0; j < factor.second; ++j) {
+            const HugeInt candidate{divexact(order, factor.first)};
+            if (mont.power(x, candidate) != mont.one()) {
+                break;
+            }
+            order = candidate;
+        }
+    }
+
+    return order;
+}
+
+/**
+ * primitive_root:
+ *
+ * Return the least primitive root g modulo the prime p, i.e., the least g
+ * whose multiplicative order is p - 1: g^((p-1)/q) != 1 (mod p) for every
+ * prime factor q of p - 1.
+ *
+ * @param p
+ * @return
+ */
+
+HugeInt primitive_root(const HugeInt& p) {
+    if (p == 2LL) {
+        return 1LL;
+    }
+
+    const HugeInt    pm1{p - 1LL};
+    const Montgomery mont{p};
+
+    std::vector<HugeInt> cofactors;
+    for (const auto& factor : factorize(pm1)) {
+        cofactors.push_back(divexact(pm1, factor.first));
+    }
+
+    for (long long g = 2; ; ++g) {
+        const HugeInt gm{mont.toMontgomery(g)};
+        bool          generator{true};
+
+        for (const HugeInt& cofactor : cofactors) {
+            if (mont.power(gm, cofactor) == mont.one()) {
+                generator = false;
+                break;
+            }
+        }
+
+        if (generator) {
+            return g;
+        }
+    }
+}
+
+} /* namespace iota */
@@ -0,0 +1,50 @@
+/*
+ * NumberTheory.h
+ *
+ * Number-theoretic functions operating on HugeInts.
+ *
+ * Integer roots: isqrt and iroot return the truncated (floor) root of their
+ * argument, optionally together with the remainder n - root^k, as for
+ * unsigned_divide. The perfect square/power predicates filter their argument
+ * through cheap tests (quadratic residues, 2-adic valuation) before any root
+ * is computed.
+ *
+ * Modular functions (powmod, is_probable_prime, factorize, sqrtmod,
+ * multiplicative_order, primitive_root) do their arithmetic with Montgomery
+ * multiplication for odd moduli (see Montgomery.h), so that repeated
+ * full-width operator% is avoided. The Jacobi symbol is computed with a
+ * binary algorithm directly on the base 2^32 digits, without divisions.
+ */
+
+#ifndef NUMBERTHEORY_H
+#define NUMBERTHEORY_H
+
+#include "HugeInt.h"
+#include <utility>
+#include <vector>
+
+namespace iota {
+
+// integer roots
+HugeInt isqrt(const HugeInt&, HugeInt* const remainder = nullptr);
+HugeInt iroot(const HugeInt&, int, HugeInt* const remainder = nullptr);
+bool    is_perfect_square(const HugeInt&);
+bool    is_perfect_power(const HugeInt&);
+
+// divisibility and primality
+HugeInt gcd(const HugeInt&, const HugeInt&);
+HugeInt invmod(const HugeInt&, const HugeInt&);
+HugeInt crt(const std::vector<HugeInt>&, const std::vector<HugeInt>&);
+HugeInt powmod(const HugeInt&, const HugeInt&, const HugeInt&);
+bool    is_probable_prime(const HugeInt&, int rounds = 25);
+std::vector<std::pair<HugeInt, int>> factorize(const HugeInt&);
+
+// quadratic residues and multiplicative structure modulo a prime
+int     jacobi(const HugeInt&, const HugeInt&);
+HugeInt sqrtmod(const HugeInt&, const HugeInt&);
+HugeInt multiplicative_order(const HugeInt&, const HugeInt&);
+HugeInt primitive_root(const HugeInt&);
+
+} /* namespace iota */
+
+#endif /* NUMBERTHEORY_H */
@@ -0,0 +1,566 @@
+/*
+ * Rational.cpp
+ *
+ * Implementation of the Rational class. See comments in Rational.h for
+ * details.
+ *
+ */
+
+#include "Rational.h"
+#include "NumberTheory.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+
+/*
+ * Non-member utility functions (in anonymous namespace -- file scope only).
+ *
+ */
+
+namespace { /* anonymous namespace */
+
+using iota::HugeInt;
+
+/*
+ * Return |x|.
+ *
+ */
+
+inline HugeInt magnitude(const HugeInt& x) {
+    return x.isNegative() ? -x : x;
+}
+
+/*
+ * Return the number of bits in |x|.
+ *
+ */
+
+inline int bit_length(const HugeInt& x) {
+    return magnitude(x).bitLength();
+}
+
+/*
+ * Return true if x = 1.
+ *
+ */
+
+inline bool is_one(const HugeInt& x) {
+    return x == 1LL;
+}
+
+/*
+ * Return x / 2^excess as a long double, where excess is chosen to leave the
+ * top 64 bits of |x| (x >= 0).
+ *
+ */
+
+long double top_bits(HugeInt x, int& excess) {
+    excess = std::max(0, x.bitLength() - 64);
+
+    return static_cast<long double>(x.shiftRightBits(excess));
+}
+
+} /* anonymous namespace */
+
+
+
+namespace iota {
+
+/**
+ * Constructor: conversion from long long int.
+ *
+ * @param value
+ */
+
+Rational::Rational(long long int value) : numerator_{value} {
+}
+
+/**
+ * Constructor: conversion from HugeInt.
+ *
+ * @param value
+ */
+
+Rational::Rational(const HugeInt& value) : numerator_{value} {
+}
+
+/**
+ * Constructor: numerator / denominator. The fraction is not reduced, but
+ * the sign is moved to the numerator. Throws std::domain_error if the
+ * denominator is zero.
+ *
+ * @param numerator
+ * @param denominator
+ */
+
+Rational::Rational(const HugeInt& numerator, const HugeInt& denominator)
+    : numerator_{numerator}, denominator_{denominator} {
+    if (denominator_.isZero()) {
+        throw std::domain_error{"Rational with zero denominator."};
+    }
+
+    if (denominator_.isNegative()) {
+        numerator_ = -numerator_;
+        denominator_ = -denominator_;
+    }
+
+    reduced_ = is_one(denominator_);
+    reduceIfLarge();
+}
+
+/**
+ * Constructor: conversion from a C string of the form "[+/-]p" or
+ * "[+/-]p/q", where p and q are strings of decimal digits. Throws
+ * std::invalid_argument if the string is not of this form and
+ * std::domain_error if q is zero.
+ *
+ * @param str
+ */
+
+Rational::Rational(const char* const str) {
+    const char* const slash{std::strchr(str, '/')};
+
+    if (slash == nullptr) {
+        *this = Rational{HugeInt{str}};
+        return;
+    }
+
+    if (slash[1] == '+' || slash[1] == '-') {
+        throw std::invalid_argument{"Rational denominator has a sign."};
+    }
+
+    const std::string numerator(str, slash);
+
+    *this = Rational{HugeInt{numerator.c_str()}, HugeInt{slash + 1}};
+}
+
+/**
+ * Unary minus operator
+ *
+ * @return
+ */
+
+Rational Rational::operator-() const {
+    Rational result{*this};
+
+    result.numerator_ = -numerator_;
+
+    return result;
+}
+
+/**
+ * floor()
+ *
+ * Return the largest integer <= the Rational.
+ *
+ * @return
+ */
+
+HugeInt Rational::floor() const {
+    HugeInt remainder;
+    HugeInt quotient{unsigned_divide(magnitude(numerator_), denominator_,
+                                     &remainder)};
+
+    if (numerator_.isNegative()) {
+        quotient = -quotient;
+        if (!remainder.isZero()) {
+            --quotient;
+        }
+    }
+
+    return quotient;
+}
+
+/**
+ * operator long double()
+ *
+ * Use with static_cast<long double>(x) to convert x to its approximate
+ * (long double) floating point value. Numerator and denominator are each
+ * cut to their top 64 bits, so the quotient cannot overflow unless the
+ * value itself does.
+ *
+ */
+
+Rational::operator long double() const {
+    int excessNumerator;
+    int excessDenominator;
+
+    const long double n{top_bits(magnitude(numerator_), excessNumerator)};
+    const long double d{top_bits(denominator_, excessDenominator)};
+    const long double value{std::ldexp(n / d,
+                                       excessNumerator - excessDenominator)};
+
+    return numerator_.isNegative() ? -value : value;
+}
+
+/**
+ * friend binary operator +
+ *
+ * Return a/b + c/d. Equal denominators are added directly. Otherwise, if
+ * the denominators are small the result is (ad + cb)/(bd), unreduced
+ * (except when b or d is 1). If they are large, Henrici's method is used:
+ * with g = gcd(b, d) and t = a(d/g) + c(b/g), the sum is
+ * (t/g')/((b/g)(d/g')), g' = gcd(t, g), which is in lowest terms if both
+ * operands were.
+ *
+ * @param x
+ * @param y
+ * @return
+ */
+
+Rational operator+(const Rational& x, const Rational& y) {
+    const HugeInt& a{x.numerator_};
+    const HugeInt& b{x.denominator_};
+    const HugeInt& c{y.numerator_};
+    const HugeInt& d{y.denominator_};
+    Rational       result;
+
+    if (b == d) {
+        result.numerator_ = a + c;
+        result.denominator_ = b;
+        result.reduced_ = is_one(b);
+    }
+    else if (b.bitLength() + d.bitLength() <= Rational::reductionThreshold) {
+        result.numerator_ = a * d + c * b;
+        result.denominator_ = b * d;
+        result.reduced_ = (is_one(b) && y.reduced_) ||
+                          (is_one(d) && x.reduced_);
+    }
+    else {
+        const HugeInt g{gcd(b, d)};
+        const HugeInt bg{divexact(b, g)};
+        const HugeInt t{a * divexact(d, g) + c * bg};
+        const HugeInt h{gcd(t, g)};
+
+        result.numerator_ = divexact(t, h);
+        result.denominator_ = bg * divexact(d, h);
+        result.reduced_ = x.reduced_ && y.reduced_;
+    }
+
+    return result.reduceIfLarge();
+}
+
+/**
+ * friend binary operator -
+ *
+ * Return x - y, as x + (-y).
+ *
+ * @param x
+ * @param y
+ * @return
+ */
+
+Rational operator-(const Rational& x, const Rational& y) {
+    return x + (-y);
+}
+
+/**
+ * friend binary operator *
+ *
+ * Return (a/b)(c/d). If the product would be small, it is (ac)/(bd),
+ * unreduced. Otherwise, common factors are cancelled across the operands
+ * first: with g1 = gcd(a, d) and g2 = gcd(c, b), the product is
+ * ((a/g1)(c/g2))/((b/g2)(d/g1)), which is in lowest terms if both operands
+ * were.
+ *
+ * @param x
+ * @param y
+ * @return
+ */
+
+Rational operator*(const Rational& x, const Rational& y) {
+    const HugeInt& a{x.numerator_};
+    const HugeInt& b{x.denominator_};
+    const HugeInt& c{y.numerator_};
+    const HugeInt& d{y.denominator_};
+    Rational       result;
+
+    if (bit_length(a) + bit_length(c) <= Rational::reductionThreshold &&
+        b.bitLength() + d.bitLength() <= Rational::reductionThreshold) {
+        result.numerator_ = a * c;
+        result.denominator_ = b * d;
+        result.reduced_ = is_one(result.denominator_);
+    }
+    else {
+        const HugeInt g1{gcd(a, d)};
+        const HugeInt g2{gcd(c, b)};
+
+        result.numerator_ = divexact(a, g1) * divexact(c, g2);
+        result.denominator_ = divexact(b, g2) * divexact(d, g1);
+        result.reduced_ = x.reduced_ && y.reduced_;
+    }
+
+    return result.reduceIfLarge();
+}
+
+/**
+ * friend binary operator /
+ *
+ * Return x / y, as x times the reciprocal of y. Throws std::domain_error
+ * if y is zero.
+ *
+ * @param x
+ * @param y
+ * @return
+ */
+
+Rational operator/(const Rational& x, const Rational& y) {
+    if (y.isZero()) {
+        throw std::domain_error{"Rational division by zero."};
+    }
+
+    Rational reciprocal;
+
+    reciprocal.numerator_ = y.denominator_;
+    reciprocal.denominator_ = y.numerator_;
+    if (reciprocal.denominator_.isNegative()) {
+        reciprocal.numerator_ = -reciprocal.numerator_;
+        reciprocal.denominator_ = -reciprocal.denominator_;
+    }
+    reciprocal.reduced_ = y.reduced_;
+
+    return x * reciprocal;
+}
+
+Rational& Rational::operator+=(const Rational& y) {
+    *this = *this + y;
+
+    return *this;
+}
+
+Rational& Rational::operator-=(const Rational& y) {
+    *this = *this - y;
+
+    return *this;
+}
+
+Rational& Rational::operator*=(const Rational& y) {
+    *this = *this * y;
+
+    return *this;
+}
+
+Rational& Rational::operator/=(const Rational& y) {
+    *this = *this / y;
+
+    return *this;
+}
+
+/**
+ * Relational operators: exact comparison of the values. Two fractions known
+ * to be in lowest terms are equal only if their numerators and denominators
+ * are; otherwise equality is tested by cross-multiplication.
+ *
+ * @param x
+ * @param y
+ * @return
+ */
+
+bool operator==(const Rational& x, const Rational& y) {
+    if (x.reduced_ && y.reduced_) {
+        return x.numerator_ == y.numerator_ &&
+               x.denominator_ == y.denominator_;
+    }
+
+    return Rational::compare(x, y) == 0;
+}
+
+bool operator!=(const Rational& x, const Rational& y) {
+    return !(x == y);
+}
+
+bool operator<(const Rational& x, const Rational& y) {
+    return Rational::compare(x, y) < 0;
+}
+
+bool operator>(const Rational& x, const Rational& y) {
+    return Rational::compare(x, y) > 0;
+}
+
+bool operator<=(const Rational& x, const Rational& y) {
+    return Rational::compare(x, y) <= 0;
+}
+
+bool operator>=(const Rational& x, const Rational& y) {
+    return Rational::compare(x, y) >= 0;
+}
+
+/**
+ * toString()
+ *
+ * Format the Rational in lowest terms as "p/q", or as "p" if it is an
+ * integer, e.g., "-22/7".
+ *
+ * @return
+ */
+
+std::string Rational::toString() const {
+    normalize();
+
+    std::string result{numerator_.toDigitString()};
+    if (!is_one(denominator_)) {
+        result += "/" + denominator_.toDigitString();
+    }
+
+    return result;
+}
+
+/**
+ * operator<<
+ *
+ * Overloaded stream insertion for Rational, in the format of toString().
+ *
+ * @param output
+ * @param x
+ * @return
+ */
+
+std::ostream& operator<<(std::ostream& output, const Rational& x) {
+    return output << x.toString();
+}
+
+/**
+ * getNumerator()
+ *
+ * @return
+ */
+
+const HugeInt& Rational::getNumerator() const {
+    normalize();
+
+    return numerator_;
+}
+
+/**
+ * getDenominator()
+ *
+ * @return
+ */
+
+const HugeInt& Rational::getDenominator() const {
+    normalize();
+
+    return denominator_;
+}
+
+/**
+ * isZero()
+ *
+ * @return
+ */
+
+bool Rational::isZero() const {
+    return numerator_.isZero();
+}
+
+/**
+ * isNegative()
+ *
+ * @return
+ */
+
+bool Rational::isNegative() const {
+    return numerator_.isNegative();
+}
+
+/**
+ * isInteger()
+ *
+ * @return
+ */
+
+bool Rational::isInteger() const {
+    return is_one(getDenominator());
+}
+
+/**
+ * normalize()
+ *
+ * Reduce the Rational to lowest terms, if it is not known to be already.
+ * The value is unchanged, so this is a const operation on mutable members.
+ *
+ * @return
+ */
+
+const Rational& Rational::normalize() const {
+    if (reduced_) {
+        return *this;
+    }
+
+    const HugeInt g{gcd(numerator_, denominator_)};
+
+    if (!is_one(g)) {
+        numerator_ = divexact(numerator_, g);
+        denominator_ = divexact(denominator_, g);
+    }
+    reduced_ = true;
+
+    return *this;
+}
+
+/**
+ * reduceIfLarge: (private utility function)
+ *
+ * Reduce the Rational to lowest terms if its numerator or denominator is
+ * longer than reductionThreshold bits.
+ *
+ * @return
+ */
+
+Rational& Rational::reduceIfLarge() {
+    if (!reduced_ && (bit_length(numerator_) > reductionThreshold ||
+                      denominator_.bitLength() > reductionThreshold)) {
+        normalize();
+    }
+
+    return *this;
+}
+
+/**
+ * compare: (private utility function)
+ *
+ * Return -1, 0 or 1 as x < y, x == y or x > y. For x = a/b and y = c/d of
+ * the same sign, |a| d and |c| b have bit lengths in
+ * [len(a) + len(d) - 1, len(a) + len(d)] and likewise for |c| b, so the
+ * cross products need only be formed when these ranges overlap.
+ *
+ * @param x
+ * @param y
+ * @return
+ */
+
+int Rational::compare(const Rational& x, const Rational& y) {
+    const int signX{x.isNegative() ? -1 : (x.isZero() ? 0 : 1)};
+    const int signY{y.isNegative() ? -1 : (y.isZero() ? 0 : 1)};
+
+    if (signX != signY || signX == 0) {
+        return signX < signY ? -1 : (signX > signY ? 1 : 0);
+    }
+
+    const HugeInt magnitudeX{magnitude(x.numerator_)};
+    const HugeInt magnitudeY{magnitude(y.numerator_)};
+    const int     lengthX{magnitudeX.bitLength() + y.denominator_.bitLength()};
+    const int     lengthY{magnitudeY.bitLength() + x.denominator_.bitLength()};
+    int           order;
+
+    if (lengthX + 1 < lengthY) {
+        order = -1;
+    }
+    else if (lengthY + 1 < lengthX) {
+        order = 1;
+    }
+    else {
+        const HugeInt crossX{magnitudeX * y.denominator_};
+        const HugeInt crossY{magnitudeY * x.denominator_};
+
+        order = crossX < crossY ? -1 : (crossX > crossY ? 1 : 0);
+    }
+
+    return signX * order;
+}
+
+} /* namespace iota */
@@ -0,0 +1,102 @@
+/*
+ * Rational.h
+ *
+ * Exact rational numbers with HugeInt numerator and denominator.
+ *
+ * A Rational holds numerator / denominator with a positive denominator, but
+ * is not necessarily in lowest terms: gcd reduction is deferred until the
+ * numerator or denominator grows beyond reductionThreshold bits, or until
+ * the value is output or its numerator and denominator are requested (the
+ * members are mutable, so that this can happen behind a const interface).
+ * A flag records whether the fraction is known to be in lowest terms.
+ *
+ * When the operands are large, multiplication cancels across the fractions
+ * before multiplying,
+ *
+ *     (a/b) (c/d) = ((a/g1)(c/g2)) / ((b/g2)(d/g1)),  g1 = (a, d), g2 = (c, b),
+ *
+ * and addition uses g = (b, d) to form (a (d/g) + c (b/g)) / ((b/g) d) and
+ * removes what remains of g from the numerator (Henrici's method; Knuth,
+ * TAOCP 4.5.1), so that the gcds are taken of operands half the size of
+ * those of a full reduction, and the result is in lowest terms if the
+ * operands were. Small operands are combined directly.
+ *
+ * Comparisons are by cross-multiplication, a d <=> c b, after checks of the
+ * signs and bit lengths that settle most cases without multiplying.
+ *
+ * As with HugeInt, results that exceed its capacity are silently truncated.
+ * Numerators and denominators of up to 4000 bits in lowest terms are safe
+ * in the default configuration.
+ */
+
+#ifndef RATIONAL_H
+#define RATIONAL_H
+
+#include "HugeInt.h"
+#include <iosfwd>
+#include <string>
+
+namespace iota {
+
+class Rational {
+public:
+    Rational(long long int value = 0);
+    Rational(const HugeInt&);
+    Rational(const HugeInt&, const HugeInt&); // numerator, denominator != 0
+    explicit Rational(const char* const);    // "[+/-]p" or "[+/-]p/q"
+
+    // unary minus operator
+    Rational operator-() const;
+
+    // conversions
+    HugeInt floor() const;
+    explicit operator long double() const;
+
+    // basic arithmetic
+    friend Rational operator+(const Rational&, const Rational&);
+    friend Rational operator-(const Rational&, const Rational&);
+    friend Rational operator*(const Rational&, const Rational&);
+    friend Rational operator/(const Rational&, const Rational&);
+
+    Rational& operator+=(const Rational&);
+    Rational& operator-=(const Rational&);
+    Rational& operator*=(const Rational&);
+    Rational& operator/=(const Rational&);
+
+    // relational operators
+    friend bool operator==(const Rational&, const Rational&);
+    friend bool operator!=(const Rational&, const Rational&);
+    friend bool operator<(const Rational&, const Rational&);
+    friend bool operator>(const Rational&, const Rational&);
+    friend bool operator<=(const Rational&, const Rational&);
+    friend bool operator>=(const Rational&, const Rational&);
+
+    // input/output (in lowest terms)
+    std::string toString() const;
+    friend std::ostream& operator<<(std::ostream&, const Rational&);
+
+    // informational (in lowest terms)
+    const HugeInt& getNumerator() const;
+    const HugeInt& getDenominator() const;
+    bool           isZero() const;
+    bool           isNegative() const;
+    bool           isInteger() const;
+
+    const Rational& normalize() const;
+
+    // no. bits beyond which a numerator or denominator forces a reduction
+    static const int reductionThreshold{2048};
+
+private:
+    mutable HugeInt numerator_;
+    mutable HugeInt denominator_{1LL};   // always positive
+    mutable bool    reduced_{true};      // known to be in lowest terms
+
+    // private utility functions
+    Rational&  reduceIfLarge();
+    static int compare(const Rational&, const Rational&);
+};
+
+} /* namespace iota */
+
+#endif /* RATIONAL_H */
@@ -0,0 +1,162 @@
+/*
+ * Reduction.h
+ *
+ * Parallel sums and products over ranges of HugeInts.
+ *
+ * parallel_sum cuts the range [first, last) into one contiguous block per
+ * thread and sums each block on its own thread into a HugeIntAccumulator,
+ * so that no carries are propagated until the per-thread totals are read
+ * and combined.
+ *
+ * parallel_product multiplies by a balanced product tree: the range is
+ * halved recursively and the products of the halves multiplied, so that
+ * the operands of each multiplication are of similar size (and large ones
+ * reach the Karatsuba kernels), instead of one growing product being
+ * multiplied by each small value in turn. The halves down to
+ * ceil(log2(threads)) levels are multiplied on separate threads.
+ *
+ * The iterators need only be forward iterators, the requirement of the
+ * std::execution::par algorithms, and the value type must convert to
+ * HugeInt. As with the arithmetic operators, results that are not
+ * representable are silently truncated.
+ */
+
+#ifndef REDUCTION_H
+#define REDUCTION_H
+
+#include "HugeInt.h"
+#include "HugeIntAccumulator.h"
+#include <algorithm>
+#include <future>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+namespace iota {
+
+/**
+ * reduction_threads:
+ *
+ * Return the default number of threads for a reduction: one per hardware
+ * thread.
+ *
+ * @return
+ */
+
+inline unsigned int reduction_threads() {
+    return std::max(1U, std::thread::hardware_concurrency());
+}
+
+/**
+ * parallel_sum:
+ *
+ * Return the sum of the values in [first, last), using up to the given
+ * number of threads (each summing at least minimumBlock values).
+ *
+ * @param first
+ * @param last
+ * @param threads
+ * @return
+ */
+
+template <typename ForwardIterator>
+HugeInt parallel_sum(ForwardIterator first, ForwardIterator last,
+                     unsigned int threads = reduction_threads()) {
+    const std::size_t minimumBlock{256};
+    const std::size_t n{static_cast<std::size_t>(std::distance(first, last))};
+    const std::size_t blocks{std::max<std::size_t>(1,
+                                 std::min<std::size_t>(threads,
+                                                       n / minimumBlock))};
+
+    auto sum_block = [](ForwardIterator begin, ForwardIterator end) {
+        HugeIntAccumulator total;
+        for ( ; begin != end; ++begin) {
+            total.add(HugeInt{*begin});
+        }
+        return total.value();
+    };
+
+    std::vector<std::future<HugeInt>> partials;
+    ForwardIterator                   begin{first};
+
+    for (std::size_t b = 1; b < blocks; ++b) {
+        ForwardIterator end{std::next(begin, n / blocks)};
+        partials.push_back(std::async(std::launch::async, sum_block,
+                                      begin, end));
+        begin = end;
+    }
+
+    HugeIntAccumulator total{sum_block(begin, last)};
+    for (std::future<HugeInt>& partial : partials) {
+        total.add(partial.get());
+    }
+
+    return total.value();
+}
+
+/**
+ * product_tree:
+ *
+ * Return the product of the n values starting at first, n > 0, by a
+ * balanced product tree whose top `depth' levels run their left halves
+ * asynchronously. See parallel_product.
+ *
+ * @param first
+ * @param n
+ * @param depth
+ * @return
+ */
+
+template <typename ForwardIterator>
+HugeInt product_tree(ForwardIterator first, std::size_t n, int depth) {
+    if (n == 1) {
+        return HugeInt{*first};
+    }
+
+    const std::size_t     half{n / 2};
+    const ForwardIterator middle{std::next(first, half)};
+
+    if (depth > 0) {
+        auto left = std::async(std::launch::async, [=] {
+            return product_tree(first, half, depth - 1);
+        });
+        const HugeInt right{product_tree(middle, n - half, depth - 1)};
+
+        return left.get() * right;
+    }
+
+    return product_tree(first, half, 0) * product_tree(middle, n - half, 0);
+}
+
+/**
+ * parallel_product:
+ *
+ * Return the product of the values in [first, last) (1 for an empty
+ * range), using up to the given number of threads.
+ *
+ * @param first
+ * @param last
+ * @param threads
+ * @return
+ */
+
+template <typename ForwardIterator>
+HugeInt parallel_product(ForwardIterator first, ForwardIterator last,
+                         unsigned int threads = reduction_threads()) {
+    const std::size_t n{static_cast<std::size_t>(std::distance(first, last))};
+
+    if (n == 0) {
+        return HugeInt{1LL};
+    }
+
+    int depth{0};
+    while ((1U << depth) < threads && (std::size_t{2} << depth) <= n) {
+        ++depth;
+    }
+
+    return product_tree(first, n, depth);
+}
+
+} /* namespace iota */
+
+#endif /* REDUCTION_H */
@@ -0,0 +1,132 @@
+/*
+ * ConstantsBench.cpp
+ *
+ * Benchmark of the computation of pi, e and sqrt(2) (see Constants.h),
+ * reporting the time spent in each phase: binary splitting, the final
+ * division, the integer square root and the decimal conversion.
+ *
+ * Each constant is computed and formatted to each of the given numbers of
+ * decimal places (100, 400 and maxConstantDigits by default), the given
+ * number of times (5 by default). The results are written to standard
+ * output as a JSON document giving, for each case, the mean wall-clock
+ * time per computation of each phase and in total, in ms, and the first
+ * digits of the value as a sanity check.
+ *
+ * Usage:
+ *
+ *   constants [repetitions] [digits ...]
+ *
+ * Build from the repository root with, e.g.,
+ *
+ *   g++ -std=c++17 -O2 -pthread -I. bench/ConstantsBench.cpp Constants.cpp \
+ *       HugeInt.cpp NumberTheory.cpp Montgomery.cpp -o bench/constants
+ */
+
+#include "Constants.h"
+#include "HugeInt.h"
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using iota::HugeInt;
+using iota::PhaseTimings;
+
+
+/*
+ * Non-member utility functions (in anonymous namespace -- file scope only).
+ *
+ */
+
+namespace { /* anonymous namespace */
+
+const char* const constants[]{"pi", "e", "sqrt2"};
+
+// no. leading characters of each value reported
+const std::size_t prefixLength{12};
+
+/*
+ * Compute the named constant to the given number of decimal places, adding
+ * the phase times to timings, and return it formatted.
+ *
+ */
+
+std::string compute(const std::string& name, unsigned int digits,
+                    PhaseTimings& timings) {
+    HugeInt scaled;
+
+    if (name == "pi") {
+        scaled = iota::compute_pi(digits, &timings);
+    }
+    else if (name == "e") {
+        scaled = iota::compute_e(digits, &timings);
+    }
+    else {
+        scaled = iota::compute_sqrt2(digits, &timings);
+    }
+
+    return iota::format_constant(scaled, digits, &timings);
+}
+
+} /* anonymous namespace */
+
+
+
+int main(int argc, char* argv[]) {
+    int repetitions{5};
+
+    if (argc > 1 && std::atoi(argv[1]) > 0) {
+        repetitions = std::atoi(argv[1]);
+    }
+
+    std::vector<unsigned int> places{100, 400, iota::maxConstantDigits};
+    if (argc > 2) {
+        places.clear();
+        for (int i = 2; i < argc; ++i) {
+            places.push_back(static_cast<unsigned int>(std::atol(argv[i])));
+        }
+    }
+
+    std::cout << "{\n  \"repetitions\": " << repetitions
+              << ",\n  \"results\": [";
+
+    const char* separator{"\n"};
+
+    for (const char* name : constants) {
+        for (unsigned int digits : places) {
+            PhaseTimings timings;
+            std::string  value;
+
+            try {
+                for (int i = 0; i < repetitions; ++i) {
+                    value = compute(name, digits, timings);
+                }
+            }
+            catch (const std::invalid_argument& e) {
+                std::cerr << name << " to " << digits << " places: "
+                          << e.what() << '\n';
+                return EXIT_FAILURE;
+            }
+
+            const double scale{1e3 / repetitions};      // s in total -> ms
+            const double total{timings.splitting + timings.division
+                               + timings.sqrt + timings.conversion};
+
+            std::cout << separator << "    {\"constant\": \"" << name
+                      << "\", \"digits\": " << digits
+                      << ", \"splitting_ms\": " << timings.splitting * scale
+                      << ", \"division_ms\": " << timings.division * scale
+                      << ", \"sqrt_ms\": " << timings.sqrt * scale
+                      << ", \"conversion_ms\": " << timings.conversion * scale
+                      << ", \"total_ms\": " << total * scale
+                      << ", \"value\": \"" << value.substr(0, prefixLength)
+                      << "...\"}";
+            separator = ",\n";
+        }
+    }
+
+    std::cout << "\n  ]\n}\n";
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,374 @@
+/*
+ * HugeIntBench.cpp
+ *
+ * Micro-benchmarks of the HugeInt operations: construction, parsing,
+ * printing, addition, subtraction, multiplication, squaring, division,
+ * modulus, comparison, increment and conversion to long double.
+ *
+ * Each operation is timed for operand sizes from 1 limb (base 2^32 digit)
+ * up to the full width of a HugeInt, for each of the value distributions
+ *
+ *   random     uniformly random limbs
+ *   ones       every limb 2^32 - 1, for the longest carry chains
+ *   sparse     random lowest and highest limbs, zero limbs in between
+ *   negative   negated random values
+ *
+ * The size of a case is that of its largest operand: the factors of a
+ * product and the divisor of a quotient have at most half the limbs of a
+ * HugeInt, so that no result is truncated. Every case cycles through a
+ * small pool of operands, and is repeated (in doubling batches) until it
+ * has run for at least the given time, 20 ms by default. The results are
+ * written to standard output as a JSON document giving, for each case, the
+ * number of operations timed, the mean time per operation in ns, and the
+ * throughput in limbs per ns.
+ *
+ * Where hardware performance counters are available (see PerfCounters.h),
+ * each case also reports its cycles per operation and per limb, the
+ * instructions per cycle, and the branch, L1 data and last-level cache
+ * misses per operation; the "counters" member of the report lists the
+ * events that could be counted, and any other figure is null.
+ *
+ * Usage:
+ *
+ *   bench [milliseconds per case] [operation ...]
+ *
+ * where the operations, all by default, are construct, parse, print, add,
+ * subtract, multiply, square, divide, modulo, compare, increment and
+ * convert. Build from the repository root with, e.g.,
+ *
+ *   g++ -std=c++17 -O2 -pthread -I. bench/HugeIntBench.cpp HugeInt.cpp \
+ *       -o bench/bench
+ */
+
+#include "HugeInt.h"
+#include "PerfCounters.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using iota::HugeInt;
+
+
+/*
+ * Non-member utility functions (in anonymous namespace -- file scope only).
+ *
+ */
+
+namespace { /* anonymous namespace */
+
+// no. operand sets cycled through by each case
+const std::size_t poolSize{16};
+
+// the width of a HugeInt in limbs
+const int maxLimbs{HugeInt::getMaximum().bitLength() / 32 + 1};
+
+const char* const distributions[]{"random", "ones", "sparse", "negative"};
+
+// defeats the elimination of results that are never used
+volatile bool sink;
+
+std::mt19937_64 generator{20200214};
+
+/*
+ * Return a value of the given distribution with the given number of limbs,
+ * non-negative (except for "negative") and so below 2^(32 maxLimbs - 1).
+ *
+ */
+
+HugeInt make_value(const std::string& distribution, int limbs) {
+    HugeInt value{0LL};
+
+    for (int i = limbs - 1; i >= 0; --i) {
+        std::uint32_t limb{static_cast<std::uint32_t>(generator() >> 32)};
+
+        if (distribution == "ones") {
+            limb = 0xFFFFFFFFU;
+        }
+        else if (distribution == "sparse" && i != 0 && i != limbs - 1) {
+            limb = 0;
+        }
+        if (i == limbs - 1) {
+            limb |= 1;                      // keep every limb significant
+            if (limbs == maxLimbs) {
+                limb &= 0x7FFFFFFFU;        // keep the sign bit clear
+            }
+        }
+
+        value.shiftLeftBits(32);
+        value += static_cast<long long>(limb);
+    }
+
+    return distribution == "negative" ? -value : value;
+}
+
+/*
+ * Return the sizes at which every operation is timed: 1, 2, 3, 4, 6, 8,
+ * ... (powers of two and three halves of them), and the full width.
+ *
+ */
+
+std::vector<int> limb_sizes() {
+    std::vector<int> sizes;
+
+    for (int n = 1; n < maxLimbs; n *= 2) {
+        sizes.push_back(n);
+        if (n >= 2 && n + n / 2 < maxLimbs) {
+            sizes.push_back(n + n / 2);
+        }
+    }
+    sizes.push_back(maxLimbs);
+
+    return sizes;
+}
+
+/*
+ * Run operation(k) for k = 0, 1, ... (k < poolSize) in doubling batches
+ * until at least minimumNs have elapsed, set iterations to the number of
+ * calls timed, and return the mean time per call in ns. The counters run
+ * over the timed calls.
+ *
+ */
+
+double time_case(const std::function<void(std::size_t)>& operation,
+                 double minimumNs, PerfCounters& counters, long& iterations) {
+    using Clock = std::chrono::steady_clock;
+
+    for (std::size_t k = 0; k < poolSize; ++k) {
+        operation(k);                       // warm up caches
+    }
+
+    counters.start();
+
+    const Clock::time_point start{Clock::now()};
+    double                  elapsed{0.0};
+    long                    batch{1};
+
+    for (iterations = 0; elapsed < minimumNs; batch *= 2) {
+        for (long i = 0; i < batch; ++i) {
+            operation(static_cast<std::size_t>(i) % poolSize);
+        }
+        iterations += batch;
+        elapsed = std::chrono::duration<double, std::nano>(
+                      Clock::now() - start).count();
+    }
+
+    counters.stop();
+
+    return elapsed / iterations;
+}
+
+/*
+ * Return the benchmark body for the named operation on the k'th operands
+ * of the pools a and b (with the decimal strings of a in text), storing
+ * results in the pool r, or a nullptr if the operation is unknown.
+ *
+ */
+
+std::function<void(std::size_t)> make_operation(const std::string& name,
+                                                std::vector<HugeInt>& a,
+                                                std::vector<HugeInt>& b,
+                                                std::vector<std::string>& text,
+                                                std::vector<HugeInt>& r) {
+    if (name == "construct") {
+        return [&](std::size_t k) { HugeInt x{a[k]}; sink = x.isNegative(); };
+    }
+    if (name == "parse") {
+        return [&](std::size_t k) {
+            sink = HugeInt{text[k].c_str()}.isNegative();
+        };
+    }
+    if (name == "print") {
+        return [&](std::size_t k) { sink = a[k].toDigitString().empty(); };
+    }
+    if (name == "add") {
+        return [&](std::size_t k) { r[k] = a[k] + b[k]; };
+    }
+    if (name == "subtract") {
+        return [&](std::size_t k) { r[k] = a[k] - b[k]; };
+    }
+    if (name == "multiply") {
+        return [&](std::size_t k) { r[k] = a[k] * b[k]; };
+    }
+    if (name == "square") {
+        return [&](std::size_t k) { r[k] = a[k] * a[k]; };
+    }
+    if (name == "divide") {
+        return [&](std::size_t k) { r[k] = a[k] / b[k]; };
+    }
+    if (name == "modulo") {
+        return [&](std::size_t k) { r[k] = a[k] % b[k]; };
+    }
+    if (name == "compare") {
+        return [&](std::size_t k) { sink = a[k] < b[k]; };
+    }
+    if (name == "increment") {
+        return [&](std::size_t k) { ++r[k]; };
+    }
+    if (name == "convert") {
+        return [&](std::size_t k) {
+            sink = static_cast<long double>(a[k]) > 0;
+        };
+    }
+
+    return nullptr;
+}
+
+/*
+ * Return the number of limbs of the second operand of the named operation
+ * for a case of the given size: half of it for divisors, and the same
+ * otherwise.
+ *
+ */
+
+int second_operand_limbs(const std::string& name, int limbs) {
+    if (name == "divide" || name == "modulo") {
+        return std::max(1, limbs / 2);
+    }
+
+    return limbs;
+}
+
+/*
+ * Write x as a JSON number, or null if it is not finite.
+ *
+ */
+
+void write_number(std::ostream& output, double x) {
+    if (std::isfinite(x)) {
+        output << x;
+    }
+    else {
+        output << "null";
+    }
+}
+
+/*
+ * Write the per-operation figures from the counters for a case of the given
+ * number of iterations and limbs, as JSON members.
+ *
+ */
+
+void write_counters(std::ostream& output, const PerfCounters& counters,
+                    long iterations, int limbs) {
+    const double cycles{counters.value(PerfCounters::cycles) / iterations};
+
+    output << ", \"cycles_per_op\": ";
+    write_number(output, cycles);
+    output << ", \"cycles_per_limb\": ";
+    write_number(output, cycles / limbs);
+    output << ", \"ipc\": ";
+    write_number(output, counters.value(PerfCounters::instructions)
+                         / counters.value(PerfCounters::cycles));
+
+    for (PerfCounters::Event event : {PerfCounters::branchMisses,
+                                      PerfCounters::l1Misses,
+                                      PerfCounters::llcMisses}) {
+        output << ", \"" << PerfCounters::name(event) << "_per_op\": ";
+        write_number(output, counters.value(event) / iterations);
+    }
+}
+
+} /* anonymous namespace */
+
+
+
+int main(int argc, char* argv[]) {
+    double minimumNs{20e6};
+    int    first{1};
+
+    if (argc > 1 && std::strtod(argv[1], nullptr) > 0) {
+        minimumNs = std::strtod(argv[1], nullptr) * 1e6;
+        first = 2;
+    }
+
+    std::vector<std::string> operations{"construct", "parse", "print", "add",
+                                        "subtract", "multiply", "square",
+                                        "divide", "modulo", "compare",
+                                        "increment", "convert"};
+    if (argc > first) {
+        operations.assign(argv + first, argv + argc);
+    }
+
+    PerfCounters counters;
+
+    if (!counters.anyAvailable()) {
+        std::cerr << "Hardware performance counters are not available; "
+                     "reporting wall-clock time only.\n";
+    }
+
+    std::cout << "{\n  \"limb_bits\": 32,\n  \"max_limbs\": " << maxLimbs
+              << ",\n  \"counters\": [";
+
+    const char* separator{""};
+
+    for (int e = 0; e < PerfCounters::numEvents; ++e) {
+        const PerfCounters::Event event{static_cast<PerfCounters::Event>(e)};
+
+        if (counters.available(event)) {
+            std::cout << separator << '"' << PerfCounters::name(event) << '"';
+            separator = ", ";
+        }
+    }
+
+    std::cout << "],\n  \"results\": [";
+
+    separator = "\n";
+
+    for (const std::string& name : operations) {
+        std::vector<HugeInt>     a(poolSize);
+        std::vector<HugeInt>     b(poolSize);
+        std::vector<std::string> text(poolSize);
+        std::vector<HugeInt>     r(poolSize);
+
+        const std::function<void(std::size_t)> operation{
+            make_operation(name, a, b, text, r)};
+
+        if (!operation) {
+            std::cerr << "Unknown operation: " << name << '\n';
+            return EXIT_FAILURE;
+        }
+
+        for (const char* distribution : distributions) {
+            for (int limbs : limb_sizes()) {
+                // factors have at most half the limbs of a HugeInt
+                const bool product{name == "multiply" || name == "square"};
+                if (product && 2 * limbs > maxLimbs) {
+                    continue;
+                }
+
+                for (std::size_t k = 0; k < poolSize; ++k) {
+                    a[k] = make_value(distribution, limbs);
+                    b[k] = make_value(distribution,
+                                      second_operand_limbs(name, limbs));
+                    text[k] = a[k].toDigitString();
+                    r[k] = a[k];
+                }
+
+                long         iterations;
+                const double ns{time_case(operation, minimumNs, counters,
+                                          iterations)};
+
+                std::cout << separator << "    {\"operation\": \"" << name
+                          << "\", \"distribution\": \"" << distribution
+                          << "\", \"limbs\": " << limbs
+                          << ", \"iterations\": " << iterations
+                          << ", \"ns_per_op\": " << ns
+                          << ", \"limbs_per_ns\": " << limbs / ns;
+                write_counters(std::cout, counters, iterations, limbs);
+                std::cout << '}';
+                separator = ",\n";
+            }
+        }
+    }
+
+    std::cout << "\n  ]\n}\n";
+
+    return EXIT_SUCCESS;
+}
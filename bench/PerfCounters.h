@@ -0,0 +1,231 @@
+/*
+ * PerfCounters.h
+ *
+ * Hardware performance counters for the benchmarks: CPU cycles, retired
+ * instructions, branch misses, L1 data cache read misses and last-level
+ * cache misses, counted for the calling thread (user space only) between
+ * start() and stop().
+ *
+ * On Linux the counters are opened with perf_event_open(2), one event per
+ * file descriptor, so that an event the processor or kernel does not offer
+ * (or that perf_event_paranoid forbids) leaves the others usable. When the
+ * kernel multiplexes more events than the PMU has counters, each count is
+ * scaled by the fraction of the time its event was actually scheduled.
+ * Elsewhere, or where none can be opened, no event is available, and the
+ * benchmarks fall back to wall-clock time alone.
+ */
+
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+class PerfCounters {
+public:
+    enum Event {
+        cycles,
+        instructions,
+        branchMisses,
+        l1Misses,
+        llcMisses,
+        numEvents
+    };
+
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    void start();
+    void stop();
+
+    // informational
+    bool               available(Event) const;
+    bool               anyAvailable() const;
+    double             value(Event) const;  // count at stop(); NaN if absent
+    static const char* name(Event);
+
+private:
+    int    fds_[numEvents];
+    double values_[numEvents];
+};
+
+/**
+ * Constructor
+ *
+ * Open every event that the system allows, initially disabled.
+ *
+ */
+
+inline PerfCounters::PerfCounters() {
+    for (int e = 0; e < numEvents; ++e) {
+        fds_[e] = -1;
+        values_[e] = NAN;
+    }
+
+#ifdef __linux__
+    const std::uint32_t types[numEvents]{
+        PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+        PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE};
+    const std::uint64_t configs[numEvents]{
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_BRANCH_MISSES,
+        PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                                | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+        PERF_COUNT_HW_CACHE_MISSES};
+
+    for (int e = 0; e < numEvents; ++e) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof attr);
+
+        attr.size = sizeof attr;
+        attr.type = types[e];
+        attr.config = configs[e];
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED
+                         | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        fds_[e] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1,
+                                           -1, 0));
+    }
+#endif
+}
+
+/**
+ * Destructor
+ *
+ */
+
+inline PerfCounters::~PerfCounters() {
+#ifdef __linux__
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+#endif
+}
+
+/**
+ * start:
+ *
+ * Reset and enable the available counters.
+ *
+ */
+
+inline void PerfCounters::start() {
+#ifdef __linux__
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+/**
+ * stop:
+ *
+ * Disable the available counters and read their counts, scaled for any
+ * multiplexing. An event that was never scheduled reads as NaN.
+ *
+ */
+
+inline void PerfCounters::stop() {
+#ifdef __linux__
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+
+    for (int e = 0; e < numEvents; ++e) {
+        std::uint64_t data[3];      // value, time enabled, time running
+
+        values_[e] = NAN;
+        if (fds_[e] >= 0 && read(fds_[e], data, sizeof data) == sizeof data
+            && data[2] != 0) {
+            values_[e] = static_cast<double>(data[0])
+                       * static_cast<double>(data[1]) / data[2];
+        }
+    }
+#endif
+}
+
+/**
+ * available:
+ *
+ * Return true if the given event could be opened.
+ *
+ * @param event
+ * @return
+ */
+
+inline bool PerfCounters::available(Event event) const {
+    return fds_[event] >= 0;
+}
+
+/**
+ * anyAvailable:
+ *
+ * Return true if at least one event could be opened.
+ *
+ * @return
+ */
+
+inline bool PerfCounters::anyAvailable() const {
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * value:
+ *
+ * Return the count of the given event between the last start() and stop(),
+ * or NaN if it is not available.
+ *
+ * @param event
+ * @return
+ */
+
+inline double PerfCounters::value(Event event) const {
+    return values_[event];
+}
+
+/**
+ * name:
+ *
+ * Return the name of the given event, as reported in the benchmark output.
+ * Static member function.
+ *
+ * @param event
+ * @return
+ */
+
+inline const char* PerfCounters::name(Event event) {
+    static const char* const names[numEvents]{
+        "cycles", "instructions", "branch_misses", "l1_misses", "llc_misses"};
+
+    return names[event];
+}
+
+#endif /* PERFCOUNTERS_H */
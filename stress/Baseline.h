@@ -0,0 +1,301 @@
+/*
+ * Baseline.h
+ *
+ * The original HugeInt multiplication and division, kept as a second oracle
+ * for the stress program: operator* (by shortMultiply and shiftLeftDigits),
+ * shortDivide and unsigned_divide (Knuth's Algorithm D), as they stood
+ * before the Karatsuba, squaring, reciprocal and 3-by-2 division kernels
+ * replaced them. The bodies are copied line for line, with only the changes
+ * needed to compile them outside the class:
+ *
+ *   - a HugeInt is a Digits, whose digits_ has N + 1 elements rather than
+ *     N. The original unsigned_divide writes the extra high digit of the
+ *     normalised dividend at index m, one past the end when the dividend
+ *     has all N digits; the spare element gives it somewhere to go without
+ *     changing any result;
+ *   - product += partial is done by reference::add;
+ *   - the statements `*remainder == 0LL;', comparisons whose results the
+ *     original discards, are dropped (the callers here pass zeroed
+ *     remainders, as the original callers did).
+ *
+ * Operands are unsigned (magnitudes), as for the originals.
+ */
+
+#ifndef BASELINE_H
+#define BASELINE_H
+
+#include "Reference.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace baseline {
+
+using reference::Limbs;
+
+const std::uint64_t base_{std::uint64_t{1} << 32};
+
+// the digits of a HugeInt, plus the spare high digit (see above)
+struct Digits {
+    std::vector<std::uint32_t> digits_;
+
+    Digits() : digits_(reference::width() + 1, 0) {}
+
+    explicit Digits(const Limbs& x) : Digits() {
+        std::copy(x.begin(), x.end(), digits_.begin());
+    }
+
+    Limbs limbs() const {
+        return Limbs(digits_.begin(), digits_.end() - 1);
+    }
+};
+
+inline Digits shortMultiply(const Digits& a, std::uint32_t multiplier) {
+    const int numDigits_{reference::width()};
+    Digits    product;
+
+    std::uint64_t partial{0};
+    for (int i = 0; i < numDigits_; ++i) {
+        partial += static_cast<std::uint64_t>(a.digits_[i]) * multiplier;
+        product.digits_[i] = static_cast<uint32_t>(partial);
+        partial >>= 32;
+    }
+
+    return product;
+}
+
+inline Digits& shiftLeftDigits(Digits& a, int num) {
+    const int numDigits_{reference::width()};
+
+    if (num == 0) {
+        return a;
+    }
+
+    for (int i = numDigits_ - num - 1; i >= 0; --i) {
+        a.digits_[i + num] = a.digits_[i];
+    }
+
+    for (int i = 0; i < num; ++i) {
+        a.digits_[i] = 0;
+    }
+
+    return a;
+}
+
+inline Limbs multiply(const Limbs& x, const Limbs& y) {
+    const int    numDigits_{reference::width()};
+    const Digits a{x};
+    const Digits b{y};
+    Digits       product;
+    Digits       partial;
+
+    for (int i = 0; i < numDigits_; ++i) {
+        partial = shortMultiply(a, b.digits_[i]);
+        product = Digits{reference::add(product.limbs(),
+                                        shiftLeftDigits(partial, i).limbs())};
+    }
+
+    return product.limbs();
+}
+
+inline Limbs shortDivide(const Limbs& x, std::uint32_t divisor,
+                         std::uint32_t* const remainder) {
+    const int    numDigits_{reference::width()};
+    const Digits a{x};
+    Digits       quotient;
+
+    std::uint64_t partial{0};
+    for (int i = numDigits_ - 1; i >= 0; --i) {
+        partial = base_ * partial + static_cast<std::uint64_t>(a.digits_[i]);
+        quotient.digits_[i] = static_cast<std::uint32_t>(partial / divisor);
+        partial %= divisor;
+    }
+
+    if (remainder != nullptr) {
+        *remainder = static_cast<uint32_t>(partial);
+    }
+
+    return quotient.limbs();
+}
+
+inline Limbs unsigned_divide(const Limbs& a, const Limbs& b,
+                             Limbs* const remainderLimbs) {
+    Digits  result;
+    Digits* remainder{remainderLimbs != nullptr ? &result : nullptr};
+
+    Digits dividend{a};
+    Digits divisor{b};
+
+    // Determine the number of base-2^32 digits in dividend and divisor.
+    int n{reference::width()};
+    for ( ; n > 0 && divisor.digits_[n - 1] == 0; --n);
+
+    int m{reference::width()};
+    for ( ; m > 0 && dividend.digits_[m - 1] == 0; --m);
+
+    // Technically, m can equal 0 here, if 'a' (the dividend) = 0. This is no
+    // problem as it will be caught and handled by CASE 1 below.
+
+    // CASE 1: m < n => quotient = 0; remainder = dividend.
+    Digits quotient;
+
+    if (m < n) {
+        if (remainder != nullptr) {
+            for (int i = 0; i < m; ++i) {
+                remainder->digits_[i] = dividend.digits_[i];
+            }
+            *remainderLimbs = remainder->limbs();
+        }
+
+        return quotient.limbs();
+    }
+
+    // CASE 2: Divisor has only one base-2^32 digit (n = 1). Do a short
+    //         division and return.
+    if (n < 2) {
+        std::uint64_t partial{0};
+
+        for (int i = m - 1 ; i >= 0; --i) {
+            partial = base_ * partial
+                    + static_cast<std::uint64_t>(dividend.digits_[i]);
+            quotient.digits_[i] =
+                    static_cast<std::uint32_t>(partial / divisor.digits_[0]);
+            partial %= divisor.digits_[0];
+        }
+
+        if (remainder != nullptr) {
+            remainder->digits_[0] = partial;
+            *remainderLimbs = remainder->limbs();
+        }
+
+        return quotient.limbs();
+    }
+
+    // CASE 3: m >= n and the number of digits, n, in the divisor is >= 2.
+    // Proceed with long division using Donald Knuth's Algorithm D.
+    //
+    // Determine power-of-two normalisation factor, d = 2^shifts, necessary for
+    // d * divisor.digits[n-1] >= base_ / 2.
+    int shifts{0};
+    std::uint32_t vn{divisor.digits_[n - 1]};
+
+    while (vn < (base_ >> 1)) {
+        vn <<= 1;
+        ++shifts;
+    }
+
+    // Scale the divisor and dividend by factor d, using shifts for efficiency.
+    // This scaling does not affect the quotient, but it ensures that
+    // q_k <= qhat <= q_k + 2 (see later).
+    for (int i = n - 1; i > 0; --i) {
+        divisor.digits_[i] = (divisor.digits_[i] << shifts) |
+          (static_cast<std::uint64_t>(divisor.digits_[i - 1]) >> (32 - shifts));
+    }
+    divisor.digits_[0] = divisor.digits_[0] << shifts;
+
+    // Prepend a (m+1)'th zero-value digit to the dividend, then shift.
+    dividend.digits_[m] =
+        static_cast<std::uint64_t>(dividend.digits_[m - 1]) >> (32 - shifts);
+    for (int i = m - 1; i > 0; --i) {
+        dividend.digits_[i] = (dividend.digits_[i] << shifts) |
+         (static_cast<std::uint64_t>(dividend.digits_[i - 1]) >> (32 - shifts));
+    }
+    dividend.digits_[0] = dividend.digits_[0] << shifts;
+
+    // Do the long division using the primary school algorithm, estimating
+    // partial quotients with a two most significant digit approximation for
+    // the dividend and a single most significant digit approximation for the
+    // divisor.
+    for (int k = m - n; k >= 0; --k) {
+        std::uint64_t rhat = dividend.digits_[k + n] * base_
+            + static_cast<std::uint64_t>(dividend.digits_[k + n - 1]);
+
+        std::uint64_t qhat = rhat / divisor.digits_[n - 1];
+
+        rhat %= divisor.digits_[n - 1];
+
+        // Digit q_k estimated by qhat must satisfy 0 <= q_k <= base_ - 1.
+        // If too large, decrement and adjust remainder rhat accordingly.
+        if (qhat == base_) {
+            qhat -= 1;
+            rhat += divisor.digits_[n - 1];
+        }
+
+        // Compare with a "second order" approximation to the partial quotient.
+        // If this comparison indicates that qhat overestimates, decrement,
+        // adjust remainder rhat and repeat.
+        while (rhat < base_ && (qhat * divisor.digits_[n - 2]
+                > base_ * rhat + dividend.digits_[k + n - 2])) {
+            qhat -= 1;
+            rhat += divisor.digits_[n - 1];
+        }
+
+        // We have an estimate qhat for the true digit q_k that satisfies
+        // q_k <= qhat <= q_k + 1. Calculate the corresponding remainder
+        // (a_{k+n} ... a_{k}) - qhat * (b_{n-1}...b_{0}) for this partial
+        // quotient, storing the result in digits a_{k+n}... a_{k} of the
+        // dividend. Care is taken with the carries. The overwritten digits
+        // accrue, and eventually become, the complete remainder.
+
+        std::int64_t carry{0};     // signed; carry > 0, borrow < 0
+        std::int64_t widedigit;    // signed
+        for (int i = 0; i < n; ++i) {
+            std::uint64_t product = static_cast<std::uint32_t>(qhat)
+                            * static_cast<std::uint64_t>(divisor.digits_[i]);
+
+            widedigit = (dividend.digits_[k + i] + carry)
+                        - (product & 0xffffffffLL);
+
+            dividend.digits_[k + i] = widedigit; // assigns 2^32-complement
+                                                 // if widedigit < 0
+
+            carry = (widedigit >> 32) - (product >> 32);
+        }
+
+        widedigit = dividend.digits_[k + n] + carry;
+        dividend.digits_[k + n] = widedigit;           // 2^32-complement if
+                                                       // widedigit < 0
+
+        // Accept and store the tentative quotient digit.
+        quotient.digits_[k] = qhat;
+
+        // However, since q_k <= qhat <= q_k + 1, either we have the correct
+        // digit, or we need to decrement. To resolve this, check if there was
+        // a borrow on determining the final k + n digit of the remainder. If
+        // no, we have q_k = qhat and we are done. Otherwise, qhat = q_k + 1,
+        // and we need to decrement and add the divisor to digits k + n ... k
+        // of the dividend (now the remainder).
+        if (widedigit < 0) {
+            quotient.digits_[k] -= 1;
+            widedigit = 0;
+            for (int i = 0; i < n; ++i) {
+                widedigit += static_cast<std::uint64_t>(dividend.digits_[k + i])
+                           + divisor.digits_[i];
+                dividend.digits_[k + i] = widedigit;
+                widedigit >>= 32;
+            }
+
+            dividend.digits_[k + n] += carry;
+        }
+    } /* end main loop over k */
+
+    // We are done. Return the remainder?
+    if (remainder != nullptr) {
+        // Denormalise dividend, which now contains the full remainder
+        // (stored in n - 1 digits).
+        for (int i = 0; i < n - 1; ++i) {
+            remainder->digits_[i] = (dividend.digits_[i] >> shifts) |
+                    (static_cast<std::uint64_t>(dividend.digits_[i + 1])
+                        << (32 - shifts));
+        }
+
+        remainder->digits_[n - 1] = dividend.digits_[n - 1] >> shifts;
+        *remainderLimbs = remainder->limbs();
+    }
+
+    return quotient.limbs();
+}
+
+} /* namespace baseline */
+
+#endif /* BASELINE_H */
@@ -0,0 +1,216 @@
+/*
+ * HugeIntFuzz.cpp
+ *
+ * libFuzzer target for the parsers: HugeInt(const char*), operator>>,
+ * Rational(const char*) and BigFloat(const char*). Each input (up to its
+ * first NUL) is parsed by all four, and
+ *
+ *   - a parser may reject the input only by throwing std::invalid_argument
+ *     or std::domain_error;
+ *   - HugeInt must accept exactly the strings [+-]?[0-9]+, with the value
+ *     (modulo (2^32)^N) of the reference parser of Reference.h, and print
+ *     it as the reference does; operator>> must agree with the constructor;
+ *   - Rational must accept only [+-]?[0-9]+(/[0-9]+)?, agree with HugeInt
+ *     on integers, and parse its own output back to the same value;
+ *   - BigFloat must parse its own output back.
+ *
+ * Any other outcome aborts, which libFuzzer reports with the input. Build
+ * from the repository root with, e.g.,
+ *
+ *   clang++ -std=c++17 -O1 -g -fsanitize=fuzzer,address,undefined -I. \
+ *       stress/HugeIntFuzz.cpp HugeInt.cpp Rational.cpp BigFloat.cpp \
+ *       NumberTheory.cpp Montgomery.cpp -o stress/fuzz
+ *   stress/fuzz -max_len=4096 corpus/
+ *
+ * Defining HUGEINT_FUZZ_MAIN instead of linking libFuzzer (e.g., with g++)
+ * gives a main() that runs the target once on each file named on the
+ * command line, to replay a crash or a corpus.
+ */
+
+#include "HugeInt.h"
+#include "Rational.h"
+#include "BigFloat.h"
+#include "Reference.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using iota::BigFloat;
+using iota::HugeInt;
+using iota::Rational;
+
+
+/*
+ * Non-member utility functions (in anonymous namespace -- file scope only).
+ *
+ */
+
+namespace { /* anonymous namespace */
+
+/*
+ * Abort, with a message on standard error, unless the condition holds.
+ *
+ */
+
+void require(bool condition, const char* message, const std::string& text) {
+    if (!condition) {
+        std::cerr << "FAILED: " << message << "\n  input: \"" << text
+                  << "\"\n";
+        std::abort();
+    }
+}
+
+/*
+ * Return the length of the run of decimal digits at text[start].
+ *
+ */
+
+std::size_t digits_at(const std::string& text, std::size_t start) {
+    std::size_t end{start};
+
+    while (end < text.size() && text[end] >= '0' && text[end] <= '9') {
+        ++end;
+    }
+
+    return end - start;
+}
+
+/*
+ * Return true if text has the form [+-]?[0-9]+, or, if fraction, the form
+ * [+-]?[0-9]+(/[0-9]+)?.
+ *
+ */
+
+bool is_integer(const std::string& text, bool fraction) {
+    const std::size_t sign{!text.empty() && (text[0] == '+' || text[0] == '-')
+                           ? 1U : 0U};
+    const std::size_t whole{digits_at(text, sign)};
+
+    if (whole == 0) {
+        return false;
+    }
+    if (sign + whole == text.size()) {
+        return true;
+    }
+
+    return fraction && text[sign + whole] == '/'
+           && sign + whole + 1 + digits_at(text, sign + whole + 1)
+              == text.size()
+           && digits_at(text, sign + whole + 1) > 0;
+}
+
+void fuzz_hugeint(const std::string& text) {
+    bool    accepted{true};
+    HugeInt x;
+
+    try {
+        x = HugeInt{text.c_str()};
+    }
+    catch (const std::invalid_argument&) {
+        accepted = false;
+    }
+
+    require(accepted == is_integer(text, false),
+            "HugeInt accepts exactly [+-]?[0-9]+", text);
+    if (!accepted) {
+        return;
+    }
+
+    const reference::Limbs expected{reference::parse_decimal(text)};
+
+    require(reference::from_huge(x) == expected, "HugeInt value", text);
+    require(x.toDigitString() == reference::to_decimal(expected),
+            "HugeInt toDigitString", text);
+    require(HugeInt{x.toDigitString().c_str()} == x,
+            "HugeInt round trip", text);
+
+    std::istringstream input{text};
+    HugeInt            y;
+    input >> y;
+    require(y == x, "operator>> agrees with the constructor", text);
+}
+
+void fuzz_rational(const std::string& text) {
+    Rational r;
+
+    try {
+        r = Rational{text.c_str()};
+    }
+    catch (const std::invalid_argument&) {
+        return;
+    }
+    catch (const std::domain_error&) {
+        return;
+    }
+
+    require(is_integer(text, true),
+            "Rational accepts only [+-]?[0-9]+(/[0-9]+)?", text);
+    if (is_integer(text, false)) {
+        require(r == Rational{HugeInt{text.c_str()}},
+                "Rational agrees with HugeInt", text);
+    }
+    require(Rational{r.toString().c_str()} == r, "Rational round trip", text);
+}
+
+void fuzz_bigfloat(const std::string& text) {
+    BigFloat x;
+
+    try {
+        x = BigFloat{text.c_str()};
+    }
+    catch (const std::invalid_argument&) {
+        return;
+    }
+    catch (const std::domain_error&) {
+        return;
+    }
+
+    const std::string output{x.toString(20)};
+    bool              reparsed{true};
+
+    try {
+        BigFloat{output.c_str()};
+    }
+    catch (const std::exception&) {
+        reparsed = false;
+    }
+    require(reparsed, "BigFloat parses its own output", text);
+}
+
+} /* anonymous namespace */
+
+
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data,
+                                      std::size_t size) {
+    const std::string bytes(reinterpret_cast<const char*>(data), size);
+    const std::string text{bytes.c_str()};     // up to the first NUL
+
+    fuzz_hugeint(text);
+    fuzz_rational(text);
+    fuzz_bigfloat(text);
+
+    return 0;
+}
+
+#ifdef HUGEINT_FUZZ_MAIN
+#include <fstream>
+#include <iterator>
+
+int main(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        std::ifstream     file{argv[i], std::ios::binary};
+        const std::string bytes{std::istreambuf_iterator<char>{file},
+                                std::istreambuf_iterator<char>{}};
+
+        LLVMFuzzerTestOneInput(
+            reinterpret_cast<const std::uint8_t*>(bytes.data()), bytes.size());
+    }
+
+    return EXIT_SUCCESS;
+}
+#endif
@@ -0,0 +1,842 @@
+/*
+ * HugeIntStress.cpp
+ *
+ * Differential stress test of the HugeInt operations: every operation is
+ * run on random and adversarial operands and its result checked against
+ * the slow schoolbook reference of Reference.h, and the products and
+ * quotients also against the original HugeInt kernels kept in Baseline.h.
+ *
+ * The operands are drawn, at sizes from 1 limb (base 2^32 digit) up to the
+ * full width of a HugeInt, from the kinds
+ *
+ *   random     uniformly random limbs
+ *   ones       every limb 2^32 - 1, for the longest carry chains
+ *   power      powers (2^32)^k, plus or minus a small value
+ *   sparse     random lowest and highest limbs, zero limbs in between
+ *   extreme    within a few units of getMinimum() or getMaximum()
+ *   small      0, 1, 2^31, 2^32 - 1 and the like
+ *
+ * each negated at random. For each pair (a, b) the checks cover the
+ * conversions, +, -, unary -, the relational operators, *, squaring, / and
+ * % (by q b + r == a with |r| < |b| and r of the sign of a, and against
+ * the original long division), divexact (against a and against /),
+ * shiftLeftBits, shiftRightBits, shortModulo, toDigitString and parsing
+ * (also of a full-width value, which the parallel configuration converts
+ * concurrently), the compound assignments and HugeIntAccumulator. Each
+ * iteration also checks, on operands of its own,
+ *
+ *   - BinarySplit::evaluate on a random series, and on one whose sum is
+ *     far larger than its last term, against direct summation;
+ *   - det_multimodular and det against det_bareiss (on singular matrices
+ *     too), rank, solve by substitution, and matrix products against
+ *     schoolbook sums of products;
+ *   - Montgomery add, subtract, multiply, square and power against % m;
+ *   - Rational arithmetic and comparisons against cross-multiplication,
+ *     floor against /, and every result in lowest terms;
+ *   - BigFloat add and multiply (of integers, rounded toward zero) against
+ *     the exact result truncated to the precision, and divide and sqrt at
+ *     maxPrecision against / and isqrt.
+ *
+ * The iterations cycle through
+ * configurations of the algorithm thresholds, so that the same operations
+ * run by the schoolbook kernels alone, by Karatsuba's method down to the
+ * smallest sizes (and addmul always by operator*), and concurrently, as
+ * well as with the default thresholds.
+ *
+ * Usage:
+ *
+ *   stress [iterations] [seed]
+ *
+ * with 2000 iterations and seed 1 by default. Each mismatch is reported,
+ * with the configuration and the operands, on standard error (up to 20),
+ * and the exit status is EXIT_FAILURE if there were any. Build from the
+ * repository root with, e.g.,
+ *
+ *   g++ -std=c++17 -O2 -pthread -I. stress/HugeIntStress.cpp HugeInt.cpp \
+ *       HugeIntAccumulator.cpp HugeIntMatrix.cpp Rational.cpp BigFloat.cpp \
+ *       NumberTheory.cpp Montgomery.cpp -o stress/stress
+ *
+ * preferably also with -fsanitize=address,undefined.
+ */
+
+#include "BigFloat.h"
+#include "BinarySplit.h"
+#include "HugeInt.h"
+#include "HugeIntAccumulator.h"
+#include "HugeIntMatrix.h"
+#include "Montgomery.h"
+#include "NumberTheory.h"
+#include "Rational.h"
+#include "Baseline.h"
+#include "Reference.h"
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using iota::BigFloat;
+using iota::BinarySplit;
+using iota::HugeInt;
+using iota::HugeIntAccumulator;
+using iota::HugeIntMatrix;
+using iota::Montgomery;
+using iota::Rational;
+using iota::RoundingMode;
+using reference::Limbs;
+
+
+/*
+ * Non-member utility functions (in anonymous namespace -- file scope only).
+ *
+ */
+
+namespace { /* anonymous namespace */
+
+// the algorithm thresholds under which the operations are checked
+struct Configuration {
+    const char* name;
+    int         karatsubaCutoff;
+    int         productCutoff;
+    int         parallelDepth;
+};
+
+const Configuration configurations[]{
+    {"default", HugeInt::getKaratsubaCutoff(),
+     HugeIntAccumulator::getProductCutoff(), HugeInt::getParallelDepth()},
+    {"schoolbook", INT_MAX, INT_MAX, 0},
+    {"karatsuba", 4, 1, 0},
+    {"parallel", 4, 1, 4}};
+
+// no. mismatches reported in full
+const long maxReports{20};
+
+std::mt19937_64 generator;
+long            checks{0};
+long            failures{0};
+
+// the configuration, and the operands, of the current iteration
+const Configuration* current;
+const Limbs*         operandA;
+const Limbs*         operandB;
+
+std::uint32_t random_limb() {
+    return static_cast<std::uint32_t>(generator() >> 32);
+}
+
+int random_below(int n) {
+    return static_cast<int>(generator() % static_cast<std::uint64_t>(n));
+}
+
+/*
+ * Return a size in limbs: up to twice the largest Karatsuba cutoff half of
+ * the time, where the kernels change, and up to the full width otherwise.
+ *
+ */
+
+int random_size() {
+    return 1 + random_below(random_below(2) == 0 ? 64 : reference::width());
+}
+
+/*
+ * Return an operand of a random kind and size (see the comments at the top
+ * of the file).
+ *
+ */
+
+Limbs make_operand() {
+    const int n{reference::width()};
+    const int size{random_size()};
+    Limbs     x{reference::zero()};
+    Limbs     small{reference::zero()};
+
+    small[0] = static_cast<std::uint32_t>(random_below(4));
+
+    switch (random_below(6)) {
+    case 0:                                         // random
+        for (int i = 0; i < size; ++i) {
+            x[i] = random_limb();
+        }
+        break;
+    case 1:                                         // ones
+        for (int i = 0; i < size; ++i) {
+            x[i] = 0xFFFFFFFFU;
+        }
+        break;
+    case 2:                                         // power
+        x[size - 1] = 1;
+        x = random_below(2) == 0 ? reference::add(x, small)
+                                 : reference::subtract(x, small);
+        break;
+    case 3:                                         // sparse
+        x[0] = random_limb();
+        x[size - 1] = random_limb() | 1;
+        break;
+    case 4:                                         // extreme
+        x[n - 1] = 0x80000000U;                     // the minimum
+        if (random_below(2) == 0) {
+            return reference::add(x, small);
+        }
+        small[0] += 1;                              // the maximum is min - 1
+        return reference::subtract(x, small);
+    default:                                        // small
+        switch (random_below(3)) {
+        case 0:
+            x[0] = small[0];
+            break;
+        case 1:
+            x[0] = 0x80000000U + small[0];
+            break;
+        default:
+            x[0] = 0xFFFFFFFFU - small[0];
+            break;
+        }
+        break;
+    }
+
+    return random_below(2) == 0 ? reference::negate(x) : x;
+}
+
+/*
+ * Return a HugeInt of up to the given no. uniformly random limbs, negated at
+ * random if signed.
+ *
+ */
+
+HugeInt random_huge(int limbs, bool isSigned) {
+    HugeInt value{0LL};
+
+    for (int i = random_below(limbs + 1); i > 0; --i) {
+        value.shiftLeftBits(32);
+        value += static_cast<long long>(random_limb());
+    }
+
+    return isSigned && random_below(2) == 0 ? -value : value;
+}
+
+/*
+ * Return the no. significant bits of the unsigned value x.
+ *
+ */
+
+int bit_length(const Limbs& x) {
+    for (int i = reference::width() - 1; i >= 0; --i) {
+        for (int bit = 31; bit >= 0; --bit) {
+            if ((x[i] >> bit) & 1) {
+                return 32 * i + bit + 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * Count a check, and report it if it failed.
+ *
+ */
+
+void check(bool passed, const std::string& operation) {
+    ++checks;
+
+    if (passed) {
+        return;
+    }
+
+    if (++failures <= maxReports) {
+        std::cerr << "MISMATCH in " << operation << " (configuration "
+                  << current->name << ")\n  a = "
+                  << reference::to_decimal(*operandA) << "\n  b = "
+                  << reference::to_decimal(*operandB) << '\n';
+    }
+}
+
+/*
+ * Check that the HugeInt x has the value expected.
+ *
+ */
+
+void check_value(const HugeInt& x, const Limbs& expected,
+                 const std::string& operation) {
+    check(reference::from_huge(x) == expected, operation);
+}
+
+/*
+ * Check the conversions, the additive and relational operators, and the
+ * compound assignments.
+ *
+ */
+
+void check_additive(const Limbs& a, const Limbs& b, const HugeInt& x,
+                    const HugeInt& y) {
+    const Limbs sum{reference::add(a, b)};
+    const Limbs difference{reference::subtract(a, b)};
+    Limbs       one{reference::zero()};
+
+    one[0] = 1;
+
+    check_value(x, a, "conversion");
+    check(x.isZero() == reference::is_zero(a), "isZero");
+    check(x.isNegative() == reference::is_negative(a), "isNegative");
+
+    check_value(x + y, sum, "a + b");
+    check_value(x - y, difference, "a - b");
+    check_value(-x, reference::negate(a), "-a");
+
+    const int order{reference::compare(a, b)};
+    check((x == y) == (order == 0), "a == b");
+    check((x != y) == (order != 0), "a != b");
+    check((x < y) == (order < 0), "a < b");
+    check((x > y) == (order > 0), "a > b");
+    check((x <= y) == (order <= 0), "a <= b");
+    check((x >= y) == (order >= 0), "a >= b");
+
+    HugeInt z{x};
+    check_value(z += y, sum, "a += b");
+    check_value(z -= y, a, "a += b; a -= b");
+    check_value(++z, reference::add(a, one), "++a");
+    check_value(z--, reference::add(a, one), "a--");
+    check_value(--z, reference::subtract(a, one), "--a");
+}
+
+/*
+ * Check the products: a b (both ways round), a a with the same and with
+ * equal operands, and *=.
+ *
+ */
+
+void check_multiplicative(const Limbs& a, const Limbs& b, const HugeInt& x,
+                          const HugeInt& y) {
+    const Limbs product{reference::multiply(a, b)};
+    const Limbs square{reference::multiply(a, a)};
+
+    check_value(x * y, product, "a * b");
+    check_value(x * y, baseline::multiply(a, b), "a * b (baseline)");
+    check_value(y * x, product, "b * a");
+    check_value(x * x, square, "a * a");
+    check_value(x * HugeInt{x}, square, "a * copy of a");
+
+    HugeInt z{x};
+    check_value(z *= y, product, "a *= b");
+}
+
+/*
+ * Check a / b and a % b, and divexact(a b, b) where a b is representable.
+ *
+ */
+
+void check_division(const Limbs& a, const Limbs& b, const HugeInt& x,
+                    const HugeInt& y) {
+    if (reference::is_zero(b)) {
+        bool threw{false};
+        try {
+            divexact(x, y);
+        }
+        catch (const std::domain_error&) {
+            threw = true;
+        }
+        check(threw, "divexact(a, 0) throws");
+        return;
+    }
+
+    const Limbs q{reference::from_huge(x / y)};
+    const Limbs r{reference::from_huge(x % y)};
+
+    check(reference::add(reference::multiply(q, b), r) == a,
+          "a == (a / b) b + a % b");
+    check(reference::compare_unsigned(reference::magnitude(r),
+                                      reference::magnitude(b)) < 0,
+          "|a % b| < |b|");
+    check(reference::is_zero(r)
+          || reference::is_negative(r) == reference::is_negative(a),
+          "sign of a % b");
+
+    // |a / b| and |a % b| are the unsigned quotient and remainder of |a|, |b|
+    Limbs       remainder{reference::zero()};
+    const Limbs quotient{baseline::unsigned_divide(reference::magnitude(a),
+                                                   reference::magnitude(b),
+                                                   &remainder)};
+    check(reference::magnitude(q) == quotient, "a / b (baseline)");
+    check(reference::magnitude(r) == remainder, "a % b (baseline)");
+
+    const int width{32 * reference::width()};
+    if (bit_length(reference::magnitude(a))
+        + bit_length(reference::magnitude(b)) < width) {
+        const HugeInt product{reference::to_huge(reference::multiply(a, b))};
+        check_value(divexact(product, y), a, "divexact(a b, b)");
+        check(divexact(product, y) == product / y, "divexact(a b, b) == a b / b");
+    }
+}
+
+/*
+ * Check the bit-level utilities on |a| (when a is not the minimum).
+ *
+ */
+
+void check_bits(const Limbs& a) {
+    const Limbs m{reference::magnitude(a)};
+
+    if (reference::is_negative(m)) {
+        return;
+    }
+
+    const HugeInt x{reference::to_huge(m)};
+    const int     num{random_below(200)};
+
+    check(x.bitLength() == bit_length(m), "bitLength");
+
+    HugeInt z{x};
+    check_value(z.shiftLeftBits(num), reference::shift(m, num),
+                "shiftLeftBits");
+    z = x;
+    check_value(z.shiftRightBits(num), reference::shift(m, -num),
+                "shiftRightBits");
+
+    const std::uint32_t divisors[]{random_limb() | 1, 1000000000U,
+                                   1U << random_below(32), 0xFFFFFFFFU};
+    for (std::uint32_t d : divisors) {
+        Limbs         quotient{m};
+        std::uint32_t remainder;
+
+        check(x.shortModulo(d) == reference::short_divide(quotient, d),
+              "shortModulo(" + std::to_string(d) + ")");
+        check_value(x / HugeInt{static_cast<long long>(d)},
+                    baseline::shortDivide(m, d, &remainder),
+                    "a / " + std::to_string(d) + " (baseline)");
+        check(x.shortModulo(d) == remainder,
+              "shortModulo(" + std::to_string(d) + ") (baseline)");
+    }
+}
+
+/*
+ * Check decimal printing and parsing.
+ *
+ */
+
+void check_decimal(const Limbs& a, const HugeInt& x) {
+    const std::string text{reference::to_decimal(a)};
+
+    check(x.toDigitString() == text, "toDigitString");
+    check_value(HugeInt{text.c_str()}, a, "parse");
+    if (!reference::is_negative(a)) {
+        check_value(HugeInt{("+" + text).c_str()}, a, "parse with '+'");
+    }
+}
+
+/*
+ * Check decimal printing and parsing of a value of all N random limbs, large
+ * enough that both conversions split it at parallelConversionCutoff (and so
+ * run concurrently in the parallel configuration). It is reported as a.
+ *
+ */
+
+void check_wide_decimal() {
+    Limbs w{reference::zero()};
+
+    for (std::uint32_t& limb : w) {
+        limb = random_limb();
+    }
+
+    const Limbs* const a{operandA};
+
+    operandA = &w;
+    check_decimal(w, reference::to_huge(w));
+    operandA = a;
+}
+
+/*
+ * Check a sum of terms and products formed by a HugeIntAccumulator.
+ *
+ */
+
+void check_accumulator(const Limbs& a, const Limbs& b, const HugeInt& x,
+                       const HugeInt& y) {
+    HugeIntAccumulator accumulator{x};
+    Limbs              constant{reference::zero()};
+
+    accumulator.add(y);
+    accumulator.addmul(x, y);
+    accumulator.addmul(-y, y);
+    accumulator -= x;
+    accumulator.subtract(y);
+    accumulator += x;
+    accumulator.add(12345LL);
+
+    // a + b + a b - b b - a - b + a + 12345
+    constant[0] = 12345;
+    const Limbs expected{reference::add(
+        reference::add(a, constant),
+        reference::subtract(reference::multiply(a, b),
+                            reference::multiply(b, b)))};
+
+    check_value(accumulator.value(), expected, "HugeIntAccumulator");
+}
+
+/*
+ * A series for BinarySplit given by tables of its terms a(n), p(n), q(n).
+ *
+ */
+
+struct TableSeries {
+    std::vector<HugeInt> as;
+    std::vector<HugeInt> ps;
+    std::vector<HugeInt> qs;
+
+    HugeInt a(unsigned long n) const { return as[n]; }
+    HugeInt p(unsigned long n) const { return ps[n]; }
+    HugeInt q(unsigned long n) const { return qs[n]; }
+};
+
+/*
+ * Check BinarySplit::evaluate against the exact truncated scale * S, with S
+ * summed term by term over the common denominator q(0) ... q(n): the two
+ * may differ by one unit (see BinarySplit::divide).
+ *
+ */
+
+void check_series(const TableSeries& series, const HugeInt& scale,
+                  const std::string& operation) {
+    HugeInt numerator{0LL};
+    HugeInt product{1LL};
+    HugeInt denominator{1LL};
+
+    for (std::size_t n = 0; n < series.as.size(); ++n) {
+        product *= series.ps[n];
+        denominator *= series.qs[n];
+        numerator = numerator * series.qs[n] + series.as[n] * product;
+    }
+
+    const HugeInt exact{scale * numerator / denominator};
+    const HugeInt result{BinarySplit<TableSeries>{series, 0}.evaluate(
+                             series.as.size(), scale)};
+    const HugeInt error{result - exact};
+
+    check(error >= HugeInt{-1LL} && error <= HugeInt{1LL}, operation);
+}
+
+/*
+ * Check binary splitting on a random series of up to 40 terms, with a(n) of
+ * up to 128 bits and p(n), q(n) of up to 24, and on the series with
+ * a(n) = 2^100 and p(n) = q(n) = n + 1000003 (all terms equal, so that T
+ * has some 100 bits more than Q).
+ *
+ */
+
+void check_binary_split() {
+    const int   terms{1 + random_below(40)};
+    TableSeries series;
+
+    for (int n = 0; n < terms; ++n) {
+        HugeInt a{0LL};
+        for (int i = random_below(5); i > 0; --i) {
+            a.shiftLeftBits(32);
+            a += static_cast<long long>(random_limb());
+        }
+
+        series.as.push_back(random_below(2) == 0 ? a : -a);
+        series.ps.push_back(HugeInt{1LL + random_below(1 << 24)});
+        series.qs.push_back(HugeInt{1LL + random_below(1 << 24)});
+    }
+
+    HugeInt scale{1LL};
+    for (int i = random_below(60); i > 0; --i) {
+        scale *= HugeInt{10LL};
+    }
+
+    check_series(series, scale, "BinarySplit::evaluate (random series)");
+
+    HugeInt power{1LL};
+    power.shiftLeftBits(100);
+
+    TableSeries equal;
+    for (int n = 0; n < 40; ++n) {
+        equal.as.push_back(power);
+        equal.ps.push_back(HugeInt{n + 1000003LL});
+        equal.qs.push_back(HugeInt{n + 1000003LL});
+    }
+
+    check_series(equal, HugeInt{10000000000LL},
+                 "BinarySplit::evaluate (large sum)");
+}
+
+/*
+ * Check the elimination and the products of HugeIntMatrix on a random
+ * n x n matrix A (n <= 7) of entries of up to 8 limbs, so that |det A|^2
+ * stays representable, made singular a quarter of the time by repeating a
+ * row, and a random n x k matrix B and vector v.
+ *
+ */
+
+void check_matrix() {
+    const std::size_t  n{1 + static_cast<std::size_t>(random_below(7))};
+    const std::size_t  k{1 + static_cast<std::size_t>(random_below(7))};
+    const int          limbs{1 + random_below(8)};
+    const unsigned int threads{1 + static_cast<unsigned int>(random_below(4))};
+    HugeIntMatrix      A{n, n};
+    HugeIntMatrix      B{n, k};
+    std::vector<HugeInt> v(n);
+
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            A(i, j) = random_huge(limbs, true);
+        }
+        for (std::size_t j = 0; j < k; ++j) {
+            B(i, j) = random_huge(limbs, true);
+        }
+        v[i] = random_huge(limbs, true);
+    }
+
+    const bool singular{n > 1 && random_below(4) == 0};
+    if (singular) {
+        for (std::size_t j = 0; j < n; ++j) {
+            A(n - 1, j) = A(0, j);
+        }
+    }
+
+    const HugeInt determinant{det_bareiss(A)};
+
+    check(det_multimodular(A, threads) == determinant,
+          "det_multimodular(A) == det_bareiss(A)");
+    check(det(A) == determinant, "det(A) == det_bareiss(A)");
+    check(!singular || determinant.isZero(), "det of a singular matrix");
+    check((rank(A) == n) == !determinant.isZero(), "rank(A) == n iff det");
+
+    if (!determinant.isZero()) {
+        const std::vector<Rational> x{solve(A, v)};
+        bool                        solved{true};
+
+        for (std::size_t i = 0; i < n; ++i) {
+            Rational sum;
+            for (std::size_t j = 0; j < n; ++j) {
+                sum += Rational{A(i, j)} * x[j];
+            }
+            solved = solved && sum == Rational{v[i]};
+        }
+        check(solved, "A solve(A, v) == v");
+    }
+
+    const HugeIntMatrix  product{multiply(A, B, threads)};
+    const std::vector<HugeInt> image{A * v};
+    bool                 products{true};
+
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < k; ++j) {
+            HugeInt sum{0LL};
+            for (std::size_t l = 0; l < n; ++l) {
+                sum += A(i, l) * B(l, j);
+            }
+            products = products && product(i, j) == sum;
+        }
+
+        HugeInt sum{0LL};
+        for (std::size_t l = 0; l < n; ++l) {
+            sum += A(i, l) * v[l];
+        }
+        products = products && image[i] == sum;
+    }
+    check(products, "matrix products");
+}
+
+/*
+ * Check Montgomery arithmetic modulo a random odd m > 1 of up to 64 limbs
+ * against the operators, for random residues x, y and exponent e < 2^32.
+ *
+ */
+
+void check_montgomery() {
+    HugeInt m{random_huge(64, false)};
+
+    if (m.shortModulo(2) == 0) {
+        ++m;
+    }
+    if (m == HugeInt{1LL}) {
+        m = HugeInt{3LL};
+    }
+
+    const Montgomery context{m};
+    const HugeInt    x{random_huge(64, false) % m};
+    const HugeInt    y{random_huge(64, false) % m};
+    const HugeInt    X{context.toMontgomery(x)};
+    const HugeInt    Y{context.toMontgomery(y)};
+    const long long  e{static_cast<long long>(random_limb())};
+
+    HugeInt power{1LL};
+    HugeInt square{x};
+    for (long long bits = e; bits > 0; bits >>= 1) {
+        if (bits & 1) {
+            power = power * square % m;
+        }
+        square = square * square % m;
+    }
+
+    check(context.fromMontgomery(X) == x, "Montgomery round trip");
+    check(context.fromMontgomery(context.add(X, Y)) == (x + y) % m,
+          "Montgomery add");
+    check(context.fromMontgomery(context.subtract(X, Y)) == (x - y + m) % m,
+          "Montgomery subtract");
+    check(context.fromMontgomery(context.multiply(X, Y)) == x * y % m,
+          "Montgomery multiply");
+    check(context.fromMontgomery(context.square(X)) == x * x % m,
+          "Montgomery square");
+    check(context.fromMontgomery(context.power(X, HugeInt{e})) == power % m,
+          "Montgomery power");
+}
+
+/*
+ * Check that r is in lowest terms, with a positive denominator (so 0 is
+ * 0/1), and that it equals n / d.
+ *
+ */
+
+void check_rational_value(const Rational& r, const HugeInt& n,
+                          const HugeInt& d, const std::string& operation) {
+    const HugeInt& p{r.getNumerator()};
+    const HugeInt& q{r.getDenominator()};
+
+    check(!q.isNegative() && gcd(p, q) == HugeInt{1LL},
+          operation + " in lowest terms");
+    check(p * d == n * q, operation);
+}
+
+/*
+ * Check Rational arithmetic on random fractions n1/d1 and n2/d2 of up to 8
+ * limbs.
+ *
+ */
+
+void check_rational() {
+    const HugeInt n1{random_huge(8, true)};
+    const HugeInt n2{random_huge(8, true)};
+    HugeInt       d1{random_huge(8, true)};
+    HugeInt       d2{random_huge(8, true)};
+
+    if (d1.isZero()) {
+        d1 = HugeInt{1LL};
+    }
+    if (d2.isZero()) {
+        d2 = HugeInt{-1LL};
+    }
+
+    const Rational r1{n1, d1};
+    const Rational r2{n2, d2};
+
+    check_rational_value(r1, n1, d1, "Rational(n1, d1)");
+    check_rational_value(r1 + r2, n1 * d2 + n2 * d1, d1 * d2, "r1 + r2");
+    check_rational_value(r1 - r2, n1 * d2 - n2 * d1, d1 * d2, "r1 - r2");
+    check_rational_value(r1 * r2, n1 * n2, d1 * d2, "r1 * r2");
+    if (!n2.isZero()) {
+        check_rational_value(r1 / r2, n1 * d2, d1 * n2, "r1 / r2");
+    }
+
+    // r1 < r2 iff n1 d2 < n2 d1, with the sense reversed if d1 d2 < 0
+    const bool reversed{d1.isNegative() != d2.isNegative()};
+    check((r1 < r2) == (reversed ? n2 * d1 < n1 * d2 : n1 * d2 < n2 * d1),
+          "r1 < r2");
+    check((r1 == r2) == (n1 * d2 == n2 * d1), "r1 == r2");
+
+    const HugeInt q{n1 / d1};
+    const bool    inexact{!(n1 % d1).isZero()};
+    check(r1.floor() == (inexact && n1.isNegative() != d1.isNegative()
+                         ? q - HugeInt{1LL} : q),
+          "floor(r1)");
+}
+
+/*
+ * Return x with all but its leading `precision' bits cleared (x truncated
+ * toward zero to the given precision).
+ *
+ */
+
+HugeInt truncate_bits(const HugeInt& x, int precision) {
+    HugeInt   m{x.isNegative() ? -x : x};
+    const int excess{m.bitLength() - precision};
+
+    if (excess > 0) {
+        m.shiftRightBits(excess);
+        m.shiftLeftBits(excess);
+    }
+
+    return x.isNegative() ? -m : m;
+}
+
+/*
+ * Check BigFloat arithmetic on random integers x, y of up to 64 limbs (so
+ * exact at maxPrecision), rounding toward zero.
+ *
+ */
+
+void check_bigfloat() {
+    const HugeInt  x{random_huge(64, true)};
+    const HugeInt  y{random_huge(64, true)};
+    const int      precision{2 + random_below(iota::maxPrecision - 1)};
+    const BigFloat X{x, iota::maxPrecision};
+    const BigFloat Y{y, iota::maxPrecision};
+    const RoundingMode mode{RoundingMode::towardZero};
+
+    check(X.toHugeInt() == x, "BigFloat round trip");
+    check(add(X, Y, precision, mode).toHugeInt()
+          == truncate_bits(x + y, precision), "BigFloat add");
+    check(multiply(X, Y, precision, mode).toHugeInt()
+          == truncate_bits(x * y, precision), "BigFloat multiply");
+    if (!y.isZero()) {
+        check(divide(X, Y, iota::maxPrecision, mode).toHugeInt() == x / y,
+              "BigFloat divide");
+    }
+
+    const HugeInt m{x.isNegative() ? -x : x};
+    check(sqrt(BigFloat{m, iota::maxPrecision}, iota::maxPrecision,
+               mode).toHugeInt() == iota::isqrt(m),
+          "BigFloat sqrt");
+}
+
+} /* anonymous namespace */
+
+
+
+int main(int argc, char* argv[]) {
+    const long          iterations{argc > 1 ? std::atol(argv[1]) : 2000};
+    const unsigned long seed{argc > 2 ? std::strtoul(argv[2], nullptr, 10)
+                                      : 1UL};
+
+    generator.seed(seed);
+
+    for (long i = 0; i < iterations; ++i) {
+        const Configuration& configuration{
+            configurations[i % (sizeof configurations
+                                / sizeof configurations[0])]};
+
+        HugeInt::setKaratsubaCutoff(configuration.karatsubaCutoff);
+        HugeIntAccumulator::setProductCutoff(configuration.productCutoff);
+        HugeInt::setParallelDepth(configuration.parallelDepth);
+
+        const Limbs   a{make_operand()};
+        const Limbs   b{make_operand()};
+        const HugeInt x{reference::to_huge(a)};
+        const HugeInt y{reference::to_huge(b)};
+
+        current = &configuration;
+        operandA = &a;
+        operandB = &b;
+
+        check_additive(a, b, x, y);
+        check_multiplicative(a, b, x, y);
+        check_division(a, b, x, y);
+        check_bits(a);
+        check_decimal(a, x);
+        check_wide_decimal();
+        check_accumulator(a, b, x, y);
+        check_binary_split();
+        check_matrix();
+        check_montgomery();
+        check_rational();
+        check_bigfloat();
+    }
+
+    std::cout << iterations << " iterations (seed " << seed << "), " << checks
+              << " checks, " << failures << " failures\n";
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,276 @@
+/*
+ * Reference.h
+ *
+ * A slow reference implementation of the HugeInt arithmetic, used as the
+ * oracle of the stress and fuzz programs. Values are vectors of the N base
+ * 2^32 digits (limbs) of a HugeInt, least significant first, with negative
+ * values held as radix complements, so that every result is exact modulo
+ * (2^32)^N exactly as the operators of HugeInt are.
+ *
+ * Every operation is the plainest schoolbook loop over all N limbs, with no
+ * thresholds, kernels, reciprocals or concurrency, so that it shares no
+ * code (and no fast path) with the library: only the conversions to and
+ * from HugeInt go through it, and the stress program checks that they
+ * round-trip.
+ */
+
+#ifndef REFERENCE_H
+#define REFERENCE_H
+
+#include "HugeInt.h"
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace reference {
+
+using Limbs = std::vector<std::uint32_t>;
+
+// the width of a HugeInt in limbs
+inline int width() {
+    static const int n{iota::HugeInt::getMaximum().bitLength() / 32 + 1};
+
+    return n;
+}
+
+inline Limbs zero() {
+    return Limbs(width(), 0);
+}
+
+/*
+ * Return the limbs of x, read from its raw string.
+ *
+ */
+
+inline Limbs from_huge(const iota::HugeInt& x) {
+    std::istringstream input{x.toRawString()};
+    std::vector<std::uint32_t> high;       // most significant first
+    std::uint32_t limb;
+
+    while (input >> limb) {
+        high.push_back(limb);
+    }
+
+    Limbs limbs{zero()};
+    for (std::size_t i = 0; i < high.size(); ++i) {
+        limbs[i] = high[high.size() - 1 - i];
+    }
+
+    return limbs;
+}
+
+/*
+ * Return the HugeInt of the given limbs, built by shifting in one limb at a
+ * time.
+ *
+ */
+
+inline iota::HugeInt to_huge(const Limbs& x) {
+    iota::HugeInt value{0LL};
+
+    for (int i = width() - 1; i >= 0; --i) {
+        value.shiftLeftBits(32);
+        value += static_cast<long long>(x[i]);
+    }
+
+    return value;
+}
+
+inline bool is_negative(const Limbs& x) {
+    return (x[width() - 1] >> 31) != 0;
+}
+
+inline bool is_zero(const Limbs& x) {
+    for (std::uint32_t limb : x) {
+        if (limb != 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+inline Limbs add(const Limbs& a, const Limbs& b) {
+    Limbs         sum{zero()};
+    std::uint64_t carry{0};
+
+    for (int i = 0; i < width(); ++i) {
+        carry += static_cast<std::uint64_t>(a[i]) + b[i];
+        sum[i] = static_cast<std::uint32_t>(carry);
+        carry >>= 32;
+    }
+
+    return sum;
+}
+
+inline Limbs negate(const Limbs& a) {
+    Limbs complement{zero()};
+
+    for (int i = 0; i < width(); ++i) {
+        complement[i] = ~a[i];
+    }
+
+    Limbs one{zero()};
+    one[0] = 1;
+
+    return add(complement, one);
+}
+
+inline Limbs subtract(const Limbs& a, const Limbs& b) {
+    return add(a, negate(b));
+}
+
+/*
+ * Return a b modulo (2^32)^N, by the schoolbook method over all limbs.
+ *
+ */
+
+inline Limbs multiply(const Limbs& a, const Limbs& b) {
+    Limbs product{zero()};
+
+    for (int i = 0; i < width(); ++i) {
+        std::uint64_t carry{0};
+
+        for (int j = 0; i + j < width(); ++j) {
+            carry += static_cast<std::uint64_t>(a[i]) * b[j] + product[i + j];
+            product[i + j] = static_cast<std::uint32_t>(carry);
+            carry >>= 32;
+        }
+    }
+
+    return product;
+}
+
+/*
+ * Return -1, 0 or 1 as a < b, a == b or a > b, as signed values.
+ *
+ */
+
+inline int compare(const Limbs& a, const Limbs& b) {
+    if (is_negative(a) != is_negative(b)) {
+        return is_negative(a) ? -1 : 1;
+    }
+
+    for (int i = width() - 1; i >= 0; --i) {
+        if (a[i] != b[i]) {
+            return a[i] < b[i] ? -1 : 1;
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * Return |a| as an unsigned value (so the magnitude of the minimum is
+ * itself), and compare two unsigned values.
+ *
+ */
+
+inline Limbs magnitude(const Limbs& a) {
+    return is_negative(a) ? negate(a) : a;
+}
+
+inline int compare_unsigned(const Limbs& a, const Limbs& b) {
+    for (int i = width() - 1; i >= 0; --i) {
+        if (a[i] != b[i]) {
+            return a[i] < b[i] ? -1 : 1;
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * Return x shifted left (num >= 0) or right (num < 0, unsigned) by |num|
+ * bits, one bit at a time.
+ *
+ */
+
+inline Limbs shift(Limbs x, int num) {
+    for ( ; num > 0; --num) {
+        for (int i = width() - 1; i >= 0; --i) {
+            x[i] = (x[i] << 1) | (i > 0 ? x[i - 1] >> 31 : 0);
+        }
+    }
+    for ( ; num < 0; ++num) {
+        for (int i = 0; i < width(); ++i) {
+            x[i] = (x[i] >> 1) | (i + 1 < width() ? x[i + 1] << 31 : 0);
+        }
+    }
+
+    return x;
+}
+
+/*
+ * Set the unsigned value x to x m + d (modulo (2^32)^N), in place.
+ *
+ */
+
+inline void short_multiply_add(Limbs& x, std::uint32_t m, std::uint32_t d) {
+    std::uint64_t carry{d};
+
+    for (int i = 0; i < width(); ++i) {
+        carry += static_cast<std::uint64_t>(x[i]) * m;
+        x[i] = static_cast<std::uint32_t>(carry);
+        carry >>= 32;
+    }
+}
+
+/*
+ * Divide the unsigned value x by d (0 < d < 2^32) in place, returning the
+ * remainder.
+ *
+ */
+
+inline std::uint32_t short_divide(Limbs& x, std::uint32_t d) {
+    std::uint64_t remainder{0};
+
+    for (int i = width() - 1; i >= 0; --i) {
+        remainder = (remainder << 32) | x[i];
+        x[i] = static_cast<std::uint32_t>(remainder / d);
+        remainder %= d;
+    }
+
+    return static_cast<std::uint32_t>(remainder);
+}
+
+/*
+ * Return the decimal string of a, with a leading '-' if negative.
+ *
+ */
+
+inline std::string to_decimal(const Limbs& a) {
+    Limbs       x{magnitude(a)};
+    std::string digits;
+
+    do {
+        digits.insert(digits.begin(),
+                      static_cast<char>('0' + short_divide(x, 10)));
+    } while (!is_zero(x));
+
+    return is_negative(a) ? "-" + digits : digits;
+}
+
+/*
+ * Return the value modulo (2^32)^N of a string of the form [+-]?[0-9]+,
+ * which the caller has checked.
+ *
+ */
+
+inline Limbs parse_decimal(const std::string& text) {
+    const bool  negative{text[0] == '-'};
+    std::size_t i{text[0] == '+' || text[0] == '-' ? 1U : 0U};
+    Limbs       value{zero()};
+
+    for ( ; i < text.size(); ++i) {
+        short_multiply_add(value, 10,
+                           static_cast<std::uint32_t>(text[i] - '0'));
+    }
+
+    return negative ? negate(value) : value;
+}
+
+} /* namespace reference */
+
+#endif /* REFERENCE_H */
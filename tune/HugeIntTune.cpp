@@ -0,0 +1,340 @@
+/*
+ * HugeIntTune.cpp
+ *
+ * Measures the crossovers between the algorithms of the HugeInt library on
+ * the host, and writes them to standard output as a replacement for
+ * HugeIntTuning.h:
+ *
+ *   karatsubaCutoff   operand size (in limbs, i.e., base 2^32 digits) from
+ *                     which Karatsuba's method beats schoolbook
+ *                     multiplication, timed with one level of Karatsuba
+ *                     over schoolbook sub-products
+ *   productCutoff     operand size from which HugeIntAccumulator::addmul is
+ *                     faster forming the product by operator* than adding
+ *                     the digit products into its slots
+ *   modularCutoff     no. rows from which det_multimodular (on one thread)
+ *                     beats det_bareiss, for matrices of 64-bit entries
+ *
+ * Each crossover is the least size from which the second algorithm wins at
+ * two consecutive sizes, so that a single noisy timing does not decide it.
+ * Each timing is the best mean of three runs of at least the given time,
+ * 10 ms by default. Concurrent sub-products are disabled while timing.
+ *
+ * Usage:
+ *
+ *   hugeint-tune [milliseconds per timing] > HugeIntTuning.h
+ *
+ * Build from the repository root with, e.g.,
+ *
+ *   g++ -std=c++17 -O2 -pthread -I. tune/HugeIntTune.cpp HugeInt.cpp \
+ *       HugeIntAccumulator.cpp HugeIntMatrix.cpp Rational.cpp \
+ *       NumberTheory.cpp Montgomery.cpp -o tune/hugeint-tune
+ *
+ * and rebuild the library after replacing HugeIntTuning.h.
+ */
+
+#include "HugeInt.h"
+#include "HugeIntAccumulator.h"
+#include "HugeIntMatrix.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using iota::HugeInt;
+using iota::HugeIntAccumulator;
+using iota::HugeIntMatrix;
+
+
+/*
+ * Non-member utility functions (in anonymous namespace -- file scope only).
+ *
+ */
+
+namespace { /* anonymous namespace */
+
+// no. operand sets cycled through by each timing
+const std::size_t poolSize{8};
+
+// defeats the elimination of results that are never used
+volatile bool sink;
+
+std::mt19937_64 generator{20200214};
+
+/*
+ * Return a random non-negative value of exactly the given number of limbs.
+ *
+ */
+
+HugeInt random_value(int limbs) {
+    HugeInt value{0LL};
+
+    for (int i = limbs - 1; i >= 0; --i) {
+        std::uint32_t limb{static_cast<std::uint32_t>(generator() >> 32)};
+
+        if (i == limbs - 1) {
+            limb |= 1;                      // keep every limb significant
+        }
+
+        value.shiftLeftBits(32);
+        value += static_cast<long long>(limb);
+    }
+
+    return value;
+}
+
+/*
+ * Return a random n x n matrix of signed 64-bit entries.
+ *
+ */
+
+HugeIntMatrix random_matrix(std::size_t n) {
+    HugeIntMatrix matrix(n, n);
+
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            matrix(i, j) = HugeInt{static_cast<long long>(generator())};
+        }
+    }
+
+    return matrix;
+}
+
+/*
+ * Run operation(k) for k = 0, 1, ... (k < poolSize) in doubling batches
+ * until at least minimumNs have elapsed, three times, and return the least
+ * mean time per call in ns.
+ *
+ */
+
+double time_operation(const std::function<void(std::size_t)>& operation,
+                      double minimumNs) {
+    using Clock = std::chrono::steady_clock;
+
+    double best{0.0};
+
+    for (int run = 0; run < 3; ++run) {
+        const Clock::time_point start{Clock::now()};
+        double                  elapsed{0.0};
+        long                    iterations{0};
+
+        for (long batch = 1; elapsed < minimumNs; batch *= 2) {
+            for (long i = 0; i < batch; ++i) {
+                operation(static_cast<std::size_t>(i) % poolSize);
+            }
+            iterations += batch;
+            elapsed = std::chrono::duration<double, std::nano>(
+                          Clock::now() - start).count();
+        }
+
+        const double mean{elapsed / iterations};
+        if (run == 0 || mean < best) {
+            best = mean;
+        }
+    }
+
+    return best;
+}
+
+/*
+ * Return the least of the given sizes from which faster(size) is true for
+ * two consecutive sizes, or fallback if there is none. Progress is reported
+ * on standard error.
+ *
+ */
+
+int find_crossover(const char* name, const std::vector<int>& sizes,
+                   const std::function<bool(int)>& faster, int fallback) {
+    std::cerr << name << ':';
+
+    for (std::size_t i = 0; i + 1 < sizes.size(); ++i) {
+        std::cerr << ' ' << sizes[i] << std::flush;
+        if (faster(sizes[i]) && faster(sizes[i + 1])) {
+            std::cerr << " -> " << sizes[i] << '\n';
+            return sizes[i];
+        }
+    }
+
+    std::cerr << " -> none; keeping " << fallback << '\n';
+
+    return fallback;
+}
+
+/*
+ * Return true if operator* on operands of n limbs is faster with one level
+ * of Karatsuba's method than by the schoolbook kernels.
+ *
+ */
+
+bool karatsuba_faster(int n, double minimumNs) {
+    std::vector<HugeInt> a(poolSize);
+    std::vector<HugeInt> b(poolSize);
+    std::vector<HugeInt> r(poolSize);
+
+    for (std::size_t k = 0; k < poolSize; ++k) {
+        a[k] = random_value(n);
+        b[k] = random_value(n);
+    }
+
+    const auto product = [&](std::size_t k) { r[k] = a[k] * b[k]; };
+
+    HugeInt::setKaratsubaCutoff(INT_MAX);
+    const double schoolbook{time_operation(product, minimumNs)};
+    HugeInt::setKaratsubaCutoff(n);
+    const double karatsuba{time_operation(product, minimumNs)};
+
+    return karatsuba < schoolbook;
+}
+
+/*
+ * Return true if HugeIntAccumulator::addmul on operands of n limbs is faster
+ * forming the product by operator* than by accumulating digit products.
+ *
+ */
+
+bool product_faster(int n, double minimumNs) {
+    std::vector<HugeInt> a(poolSize);
+    std::vector<HugeInt> b(poolSize);
+    HugeIntAccumulator   accumulator;
+
+    for (std::size_t k = 0; k < poolSize; ++k) {
+        a[k] = random_value(n);
+        b[k] = random_value(n);
+    }
+
+    const auto addmul = [&](std::size_t k) {
+        accumulator.addmul(a[k], b[k]);
+        if (k == poolSize - 1) {
+            sink = accumulator.value().isNegative();
+            accumulator.clear();
+        }
+    };
+
+    HugeIntAccumulator::setProductCutoff(INT_MAX);
+    const double slots{time_operation(addmul, minimumNs)};
+    HugeIntAccumulator::setProductCutoff(n);
+    const double product{time_operation(addmul, minimumNs)};
+
+    return product < slots;
+}
+
+/*
+ * Return true if det_multimodular on one thread is faster than det_bareiss
+ * for n x n matrices of 64-bit entries.
+ *
+ */
+
+bool modular_faster(int n, double minimumNs) {
+    std::vector<HugeIntMatrix> matrices;
+
+    for (std::size_t k = 0; k < poolSize; ++k) {
+        matrices.push_back(random_matrix(n));
+    }
+
+    const double bareiss{time_operation([&](std::size_t k) {
+        sink = det_bareiss(matrices[k]).isZero();
+    }, minimumNs)};
+    const double modular{time_operation([&](std::size_t k) {
+        sink = det_multimodular(matrices[k], 1).isZero();
+    }, minimumNs)};
+
+    return modular < bareiss;
+}
+
+/*
+ * Return the sizes from minimum to maximum in steps of one, and of an eighth
+ * of the size from 16 on.
+ *
+ */
+
+std::vector<int> sizes_up_to(int minimum, int maximum) {
+    std::vector<int> sizes;
+
+    for (int n = minimum; n <= maximum; n += std::max(1, n / 8)) {
+        sizes.push_back(n);
+    }
+
+    return sizes;
+}
+
+} /* anonymous namespace */
+
+
+
+int main(int argc, char* argv[]) {
+    double minimumNs{10e6};
+
+    if (argc > 1 && std::strtod(argv[1], nullptr) > 0) {
+        minimumNs = std::strtod(argv[1], nullptr) * 1e6;
+    }
+
+    HugeInt::setParallelDepth(0);
+
+    const int karatsubaCutoff{find_crossover(
+        "karatsubaCutoff", sizes_up_to(4, 128),
+        [&](int n) { return karatsuba_faster(n, minimumNs); },
+        HugeInt::getKaratsubaCutoff())};
+    HugeInt::setKaratsubaCutoff(karatsubaCutoff);
+
+    const int productCutoff{find_crossover(
+        "productCutoff", sizes_up_to(2, 128),
+        [&](int n) { return product_faster(n, minimumNs); },
+        HugeIntAccumulator::getProductCutoff())};
+
+    const int modularCutoff{find_crossover(
+        "modularCutoff", sizes_up_to(2, 24),
+        [&](int n) { return modular_faster(n, minimumNs); },
+        static_cast<int>(iota::modularCutoff))};
+
+    std::cout <<
+        "/*\n"
+        " * HugeIntTuning.h\n"
+        " *\n"
+        " * Algorithm thresholds of the HugeInt library, generated by the "
+        "tuning\n"
+        " * program tune/HugeIntTune.cpp. The crossovers between algorithms "
+        "depend on\n"
+        " * the machine, so to tune for one, build and run the tuner on it "
+        "and\n"
+        " * rebuild the library with its output in place of this file:\n"
+        " *\n"
+        " *   tune/hugeint-tune > HugeIntTuning.h\n"
+        " *\n"
+        " * The values selected here at compile time are the initial values "
+        "of the\n"
+        " * run-time settings HugeInt::setKaratsubaCutoff and\n"
+        " * HugeIntAccumulator::setProductCutoff.\n"
+        " */\n"
+        "\n"
+        "#ifndef HUGEINTTUNING_H\n"
+        "#define HUGEINTTUNING_H\n"
+        "\n"
+        "#include <cstddef>\n"
+        "\n"
+        "namespace iota {\n"
+        "namespace tuning {\n"
+        "\n"
+        "// no. digits of both factors from which operator* uses Karatsuba's "
+        "method\n"
+        "const int karatsubaCutoff{" << karatsubaCutoff << "};\n"
+        "\n"
+        "// no. digits of both factors from which HugeIntAccumulator::addmul "
+        "forms\n"
+        "// the product by operator*\n"
+        "const int productCutoff{" << productCutoff << "};\n"
+        "\n"
+        "// no. rows from which det uses det_multimodular\n"
+        "const std::size_t modularCutoff{" << modularCutoff << "};\n"
+        "\n"
+        "} /* namespace tuning */\n"
+        "} /* namespace iota */\n"
+        "\n"
+        "#endif /* HUGEINTTUNING_H */\n";
+
+    return EXIT_SUCCESS;
+}